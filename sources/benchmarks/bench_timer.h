@@ -0,0 +1,44 @@
+#ifndef _BENCH_TIMER_
+#define _BENCH_TIMER_
+
+/*
+ * Timers of the benchmarks.
+ * bench_ticks counts processor cycles where the time stamp counter is available, otherwise nanoseconds.
+ */
+
+#include <stdint.h>
+#include <time.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define BENCH_HAS_TSC 1
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define BENCH_HAS_TSC 1
+#else
+#define BENCH_HAS_TSC 0
+#endif
+
+// Wall clock time in nanoseconds
+static inline uint64_t bench_now_ns(void)
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static inline uint64_t bench_ticks(void)
+{
+#if BENCH_HAS_TSC
+    return __rdtsc();
+#else
+    return bench_now_ns();
+#endif
+}
+
+static inline const char* bench_ticks_unit(void)
+{
+    return BENCH_HAS_TSC ? "cycles" : "ns";
+}
+
+#endif
@@ -0,0 +1,92 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+#include <vector>
+extern "C" {
+#include "../hash_table_uint32/hash_table_uint32.h"
+}
+
+/*
+ * Time of loading N unique keys into an empty table for every table mode:
+ * put one by one from the default capacity, reserve and then put, and htui32_build.
+ *
+ * Usage: build_benchmark [keys_count] (up to 2^20)
+ */
+
+enum load_t {
+    LOAD_PUT,
+    LOAD_RESERVE_PUT,
+    LOAD_BUILD
+};
+
+static double load_ms(htui32_mode_t mode, load_t load, const std::vector<uint32_t>& keys)
+{
+    hash_table_uint32_t ht;
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.mode = mode;
+    htui32_init_ex(&ht, &config);
+    auto start = std::chrono::steady_clock::now();
+    switch (load) {
+    case LOAD_PUT:
+        for (uint32_t key : keys) {
+            htui32_put(&ht, key, key);
+        }
+        break;
+    case LOAD_RESERVE_PUT:
+        htui32_reserve(&ht, keys.size());
+        for (uint32_t key : keys) {
+            htui32_put(&ht, key, key);
+        }
+        break;
+    case LOAD_BUILD:
+        htui32_build(&ht, keys.data(), keys.data(), keys.size());
+        break;
+    }
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    if (ht.size != keys.size()) {
+        printf("wrong size %zu\n", ht.size);
+    }
+    htui32_destroy(&ht);
+    return elapsed.count();
+}
+
+int main(int argc, char** argv)
+{
+    size_t keys_count = 1 << 20;
+    if (argc > 1) {
+        keys_count = (size_t)strtoull(argv[1], NULL, 10);
+    }
+    // Page aligned keys like the slab mappings, there are only 2^20 of them
+    if (keys_count > ((size_t)1 << 20)) {
+        keys_count = (size_t)1 << 20;
+    }
+    std::vector<uint32_t> keys(keys_count);
+    for (size_t i = 0; i < keys_count; ++i) {
+        keys[i] = (uint32_t)(i + 1) * 4096;
+    }
+
+    struct {
+        const char* name;
+        htui32_mode_t mode;
+    } modes[] = {
+        { "chaining", HTUI32_MODE_CHAINING },
+        { "compact", HTUI32_MODE_COMPACT_CHAINING },
+        { "cuckoo", HTUI32_MODE_CUCKOO },
+        { "linear", HTUI32_MODE_LINEAR_PROBING },
+        { "robin_hood", HTUI32_MODE_ROBIN_HOOD },
+        { "swiss", HTUI32_MODE_SWISS },
+    };
+
+    printf("keys %zu\n", keys_count);
+    printf("%-12s %12s %16s %12s\n", "table", "put ms", "reserve+put ms", "build ms");
+    for (const auto& mode : modes) {
+        double put = load_ms(mode.mode, LOAD_PUT, keys);
+        double reserve_put = load_ms(mode.mode, LOAD_RESERVE_PUT, keys);
+        double build = load_ms(mode.mode, LOAD_BUILD, keys);
+        printf("%-12s %12.2f %16.2f %12.2f\n", mode.name, put, reserve_put, build);
+    }
+    return 0;
+}
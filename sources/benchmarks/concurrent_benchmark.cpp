@@ -0,0 +1,166 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+extern "C" {
+#include "../hash_table_uint32/hash_table_uint32_concurrent.h"
+#include "../hash_table_uint32/hash_table_uint32_sharded.h"
+}
+
+/*
+ * Throughput of the concurrent table and the sharded table from 1 thread up to the number of hardware threads,
+ * compared with the plain table behind one global mutex.
+ * Every thread runs the same mix of gets, puts and deletes on random keys of a shared key range.
+ * The sharded tables are measured once more with every thread using the keys of its own shards only,
+ * with the shards locked and with thread-affine shards that are not locked at all.
+ *
+ * Usage: concurrent_benchmark [keys_count] [get_percent]
+ */
+
+static uint32_t keys_count = 1 << 20;
+static uint32_t get_percent = 90;
+static const uint32_t thread_ops_count = 2000000;
+static const size_t shards_count = 64;
+
+static inline uint32_t next_random(uint32_t* state_ptr)
+{
+    // xorshift32
+    uint32_t x = *state_ptr;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state_ptr = x;
+    return x;
+}
+
+struct global_lock_table_t {
+    std::mutex mutex;
+    hash_table_uint32_t ht;
+};
+
+static void global_lock_put(global_lock_table_t* table_ptr, uint32_t key, uint32_t value)
+{
+    std::lock_guard<std::mutex> lock(table_ptr->mutex);
+    htui32_put(&table_ptr->ht, key, value);
+}
+
+static bool global_lock_get(global_lock_table_t* table_ptr, uint32_t key, uint32_t* value_ptr)
+{
+    std::lock_guard<std::mutex> lock(table_ptr->mutex);
+    return htui32_get(&table_ptr->ht, key, value_ptr);
+}
+
+static void global_lock_delete(global_lock_table_t* table_ptr, uint32_t key)
+{
+    std::lock_guard<std::mutex> lock(table_ptr->mutex);
+    htui32_delete(&table_ptr->ht, key);
+}
+
+// Runs the operation mix on the table in threads_count threads and returns the total operations per second
+// The thread t draws its keys from thread_keys[t], or from the whole key range if thread_keys is empty
+template <typename Table, typename Put, typename Get, typename Delete>
+static double run(Table* table_ptr, Put put, Get get, Delete del, uint32_t threads_count,
+    const std::vector<std::vector<uint32_t>>& thread_keys = std::vector<std::vector<uint32_t>>())
+{
+    std::vector<std::thread> threads;
+    std::vector<uint32_t> found_counts(threads_count);
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t t = 0; t < threads_count; ++t) {
+        threads.emplace_back([=, &found_counts, &thread_keys]() {
+            uint32_t state = 0x9e3779b9 * (t + 1);
+            uint32_t found_count = 0;
+            for (uint32_t i = 0; i < thread_ops_count; ++i) {
+                uint32_t r = next_random(&state);
+                uint32_t key = thread_keys.empty() ? (r % keys_count + 1) * 4096 : thread_keys[t][r % thread_keys[t].size()];
+                uint32_t op = (r >> 24) % 100;
+                if (op < get_percent) {
+                    uint32_t value = 0;
+                    found_count += get(table_ptr, key, &value) ? 1 : 0;
+                }
+                // The rest is split evenly, so the table keeps its size
+                else if ((op - get_percent) % 2 == 0) {
+                    put(table_ptr, key, i);
+                }
+                else {
+                    del(table_ptr, key);
+                }
+            }
+            found_counts[t] = found_count;
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    return (double)thread_ops_count * threads_count / seconds.count();
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1) {
+        keys_count = (uint32_t)strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        get_percent = (uint32_t)strtoul(argv[2], NULL, 10);
+    }
+    uint32_t max_threads = std::thread::hardware_concurrency();
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+    printf("keys %u, gets %u%%, %u operations per thread\n", keys_count, get_percent, thread_ops_count);
+    printf("%8s %18s %18s %10s %16s %18s %16s\n", "threads", "global lock Mops/s", "concurrent Mops/s", "scaling",
+        "sharded Mops/s", "own shards Mops/s", "affine Mops/s");
+
+    double single_thread_ops = 0;
+    for (uint32_t threads_count = 1; ; threads_count *= 2) {
+        if (threads_count > max_threads) {
+            threads_count = max_threads;
+        }
+        // All tables start half full with the same keys
+        global_lock_table_t global_lock_table;
+        htui32_init(&global_lock_table.ht, 0, 0, 0);
+        htui32_concurrent_t concurrent_table;
+        htui32_concurrent_init(&concurrent_table, NULL);
+        htui32_sharded_config_t sharded_config = {};
+        sharded_config.shards_count = shards_count;
+        htui32_sharded_t sharded_table;
+        htui32_sharded_init(&sharded_table, &sharded_config);
+        sharded_config.thread_affine = true;
+        htui32_sharded_t affine_table;
+        htui32_sharded_init(&affine_table, &sharded_config);
+        for (uint32_t i = 1; i <= keys_count; i += 2) {
+            htui32_put(&global_lock_table.ht, i * 4096, i);
+            htui32_concurrent_put(&concurrent_table, i * 4096, i);
+            htui32_sharded_put(&sharded_table, i * 4096, i);
+            htui32_sharded_put(&affine_table, i * 4096, i);
+        }
+        // The shards are dealt to the threads in turn
+        std::vector<std::vector<uint32_t>> thread_keys(threads_count);
+        for (uint32_t i = 1; i <= keys_count; ++i) {
+            thread_keys[htui32_sharded_shard_of(&affine_table, i * 4096) % threads_count].push_back(i * 4096);
+        }
+
+        double global_lock_ops = run(&global_lock_table, global_lock_put, global_lock_get, global_lock_delete, threads_count);
+        double concurrent_ops = run(&concurrent_table, htui32_concurrent_put, htui32_concurrent_get, htui32_concurrent_delete, threads_count);
+        if (threads_count == 1) {
+            single_thread_ops = concurrent_ops;
+        }
+        double sharded_ops = run(&sharded_table, htui32_sharded_put, htui32_sharded_get, htui32_sharded_delete, threads_count);
+        double own_shards_ops = run(&sharded_table, htui32_sharded_put, htui32_sharded_get, htui32_sharded_delete, threads_count, thread_keys);
+        double affine_ops = run(&affine_table, htui32_sharded_put, htui32_sharded_get, htui32_sharded_delete, threads_count, thread_keys);
+        printf("%8u %18.2f %18.2f %9.2fx %16.2f %18.2f %16.2f\n", threads_count, global_lock_ops / 1e6, concurrent_ops / 1e6,
+            concurrent_ops / single_thread_ops, sharded_ops / 1e6, own_shards_ops / 1e6, affine_ops / 1e6);
+
+        htui32_destroy(&global_lock_table.ht);
+        htui32_concurrent_destroy(&concurrent_table);
+        htui32_sharded_destroy(&sharded_table);
+        htui32_sharded_destroy(&affine_table);
+        if (threads_count == max_threads) {
+            break;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <vector>
+extern "C" {
+#include "../hash_table_uint32/hash_table_uint32.h"
+}
+
+/*
+ * Get hit and get miss time and memory per key of every table mode before and after htui32_freeze,
+ * and the time of the freeze itself.
+ *
+ * Usage: frozen_benchmark [keys_count] (up to 2^20)
+ */
+
+// Sink for the results, so that the compiler does not drop the gets
+static volatile uint32_t sink;
+
+template <typename Get>
+static double get_ns(const std::vector<uint32_t>& keys, Get get)
+{
+    uint32_t acc = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t key : keys) {
+        uint32_t value = 0;
+        acc += get(key, &value) ? value : 1;
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    sink = acc;
+    return elapsed.count() / keys.size();
+}
+
+int main(int argc, char** argv)
+{
+    size_t keys_count = 1 << 20;
+    if (argc > 1) {
+        keys_count = (size_t)strtoull(argv[1], NULL, 10);
+    }
+    // Page aligned keys like the slab mappings, hits and misses together must fit into the 2^20 of them
+    if (keys_count > ((size_t)1 << 19)) {
+        keys_count = (size_t)1 << 19;
+    }
+    std::vector<uint32_t> keys(keys_count);
+    std::vector<uint32_t> miss_keys(keys_count);
+    for (size_t i = 0; i < keys_count; ++i) {
+        keys[i] = (uint32_t)(i + 1) * 4096;
+        miss_keys[i] = (uint32_t)(keys_count + i + 1) * 4096;
+    }
+    std::vector<uint32_t> shuffled_keys = keys;
+    std::mt19937 random_engine(1);
+    std::shuffle(shuffled_keys.begin(), shuffled_keys.end(), random_engine);
+
+    struct {
+        const char* name;
+        htui32_mode_t mode;
+    } modes[] = {
+        { "chaining", HTUI32_MODE_CHAINING },
+        { "compact", HTUI32_MODE_COMPACT_CHAINING },
+        { "cuckoo", HTUI32_MODE_CUCKOO },
+        { "linear", HTUI32_MODE_LINEAR_PROBING },
+        { "robin_hood", HTUI32_MODE_ROBIN_HOOD },
+        { "swiss", HTUI32_MODE_SWISS },
+    };
+
+    printf("keys %zu\n", keys_count);
+    printf("%-12s %10s %10s %10s   %10s %10s %10s %10s\n", "", "hit ns", "miss ns", "bytes/key",
+        "freeze ms", "hit ns", "miss ns", "bytes/key");
+    for (const auto& mode : modes) {
+        hash_table_uint32_t ht;
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.mode = mode.mode;
+        htui32_init_ex(&ht, &config);
+        htui32_build(&ht, keys.data(), keys.data(), keys.size());
+
+        auto get = [&ht](uint32_t key, uint32_t* value_ptr) { return htui32_get(&ht, key, value_ptr); };
+        htui32_stats_t stats;
+        htui32_stats(&ht, &stats);
+        double hit = get_ns(shuffled_keys, get);
+        double miss = get_ns(miss_keys, get);
+        double bytes = (double)stats.memory_bytes / keys_count;
+
+        auto start = std::chrono::steady_clock::now();
+        bool is_frozen = htui32_freeze(&ht);
+        std::chrono::duration<double, std::milli> freeze = std::chrono::steady_clock::now() - start;
+        if (!is_frozen) {
+            printf("%-12s freeze failed\n", mode.name);
+            htui32_destroy(&ht);
+            continue;
+        }
+        auto frozen_get = [&ht](uint32_t key, uint32_t* value_ptr) { return htui32_frozen_get(&ht, key, value_ptr); };
+        htui32_stats(&ht, &stats);
+        double frozen_hit = get_ns(shuffled_keys, frozen_get);
+        double frozen_miss = get_ns(miss_keys, frozen_get);
+        double frozen_bytes = (double)stats.memory_bytes / keys_count;
+        printf("%-12s %10.2f %10.2f %10.2f   %10.2f %10.2f %10.2f %10.2f\n", mode.name, hit, miss, bytes,
+            freeze.count(), frozen_hit, frozen_miss, frozen_bytes);
+        htui32_destroy(&ht);
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+extern "C" {
+#include "../hash_table_uint32/hash_table_uint32.h"
+}
+
+/*
+ * Put and delete of one key alternating right at the growth threshold of the table,
+ * for several load factor limits, growth policies and modes.
+ * A table without hysteresis between growing and shrinking would rehash on every operation.
+ *
+ * Usage: growth_benchmark [min_keys] [rounds]
+ */
+
+static size_t min_keys = 1 << 17;
+static size_t rounds = 200;
+
+struct policy_t {
+    const char* name;
+    uint8_t load_fac_min;
+    uint8_t load_fac_max;
+    uint16_t growth_fac;
+    bool disable_auto_shrink;
+};
+
+static const policy_t policies[] = {
+    { "25/75", 25, 75, 0, false },
+    { "40/75", 40, 75, 0, false },
+    { "50/90", 50, 90, 0, false },
+    { "50/90x1.5", 50, 90, 150, false },
+    { "no shrink", 40, 75, 0, true },
+};
+
+static void run(const char* mode_name, htui32_mode_t mode, const policy_t& policy)
+{
+    hash_table_uint32_t ht;
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.mode = mode;
+    config.load_fac_min = policy.load_fac_min;
+    config.load_fac_max = policy.load_fac_max;
+    config.growth_fac = policy.growth_fac;
+    config.disable_auto_shrink = policy.disable_auto_shrink;
+    htui32_init_ex(&ht, &config);
+
+    // Fill the table until a put grows it, the last key is put exactly at the growth threshold
+    uint32_t key = 0;
+    size_t capacity = ht.capacity;
+    while (true) {
+        ++key;
+        htui32_put(&ht, key * 4096, key);
+        if (ht.capacity != capacity && ht.size >= min_keys) {
+            break;
+        }
+        capacity = ht.capacity;
+    }
+    htui32_delete(&ht, key * 4096);
+
+    size_t resizes_count = 0;
+    capacity = ht.capacity;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t round = 0; round < rounds; ++round) {
+        htui32_put(&ht, key * 4096, key);
+        resizes_count += (ht.capacity != capacity) ? 1 : 0;
+        capacity = ht.capacity;
+        htui32_delete(&ht, key * 4096);
+        resizes_count += (ht.capacity != capacity) ? 1 : 0;
+        capacity = ht.capacity;
+    }
+    std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+    printf("%-12s %-10s %9zu %10zu %12.1f\n", mode_name, policy.name, ht.size, resizes_count, elapsed.count() / (rounds * 2));
+    htui32_destroy(&ht);
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1) {
+        min_keys = (size_t)strtoull(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        rounds = (size_t)strtoull(argv[2], NULL, 10);
+    }
+
+    struct {
+        const char* name;
+        htui32_mode_t mode;
+    } modes[] = {
+        { "chaining", HTUI32_MODE_CHAINING },
+        { "linear", HTUI32_MODE_LINEAR_PROBING },
+        { "swiss", HTUI32_MODE_SWISS },
+    };
+
+    printf("%zu put and delete pairs at the growth threshold\n", rounds);
+    printf("%-12s %-10s %9s %10s %12s\n", "table", "policy", "keys", "resizes", "ns/op");
+    for (const auto& mode : modes) {
+        for (const policy_t& policy : policies) {
+            run(mode.name, mode.mode, policy);
+        }
+    }
+    return 0;
+}
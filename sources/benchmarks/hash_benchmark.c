@@ -0,0 +1,64 @@
+#include "../hash_table_uint32/hash_table_uint32_hash.h"
+#include "bench_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Cycles per hash of the hash functions of the table.
+ * Throughput: independent keys, the processor may overlap the hashes as it does in batch operations.
+ * Latency: every key depends on the previous hash, as in a chain of dependent lookups.
+ */
+
+#define KEYS_COUNT 4096
+#define ROUNDS 4096
+
+// Sink for the results, so that the compiler does not drop the hashing
+static volatile uint32_t sink;
+
+static uint32_t keys[KEYS_COUNT];
+
+// A separate loop per function, so the inline functions are inlined as they are in the table
+#define DEFINE_RUN(hash_func) \
+    static void run_##hash_func(void) \
+    { \
+        uint32_t acc = 0; \
+        for (size_t i = 0; i < KEYS_COUNT; ++i) { \
+            acc ^= hash_func(keys[i]); \
+        } \
+        uint64_t start = bench_ticks(); \
+        for (size_t round = 0; round < ROUNDS; ++round) { \
+            for (size_t i = 0; i < KEYS_COUNT; ++i) { \
+                acc ^= hash_func(keys[i]); \
+            } \
+        } \
+        uint64_t throughput_ticks = bench_ticks() - start; \
+        uint32_t key = 1; \
+        start = bench_ticks(); \
+        for (size_t i = 0; i < (size_t)KEYS_COUNT * ROUNDS; ++i) { \
+            key = hash_func(key) | 1; \
+        } \
+        uint64_t latency_ticks = bench_ticks() - start; \
+        sink = acc ^ key; \
+        double hashes = (double)KEYS_COUNT * ROUNDS; \
+        printf("%-28s throughput %6.2f, latency %6.2f %s per hash\n", \
+            #hash_func, throughput_ticks / hashes, latency_ticks / hashes, bench_ticks_unit()); \
+    }
+
+DEFINE_RUN(htui32_hash_murmur3)
+DEFINE_RUN(htui32_hash_fmix32)
+DEFINE_RUN(htui32_hash_multiply_shift)
+DEFINE_RUN(htui32_hash)
+
+int main(void)
+{
+    srand(1);
+    for (size_t i = 0; i < KEYS_COUNT; ++i) {
+        keys[i] = ((uint32_t)rand() << 16) ^ (uint32_t)rand();
+    }
+    run_htui32_hash_murmur3();
+    run_htui32_hash_fmix32();
+    run_htui32_hash_multiply_shift();
+    // The function the table is compiled with (HTUI32_HASH)
+    run_htui32_hash();
+    return 0;
+}
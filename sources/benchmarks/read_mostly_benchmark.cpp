@@ -0,0 +1,132 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+extern "C" {
+#include "../hash_table_uint32/hash_table_uint32_concurrent.h"
+}
+
+/*
+ * Get throughput of the concurrent table with and without the read-mostly mode
+ * from 1 reader thread up to the number of hardware threads, while one more thread keeps putting and deleting keys.
+ * The writer also deletes and puts back whole key ranges, so the table is resized under the readers.
+ *
+ * Usage: read_mostly_benchmark [keys_count] [milliseconds]
+ */
+
+static uint32_t keys_count = 1 << 20;
+static uint32_t milliseconds = 500;
+// Sink for the results, so that the compiler does not drop the gets
+static std::atomic<uint32_t> found_sink(0);
+
+static inline uint32_t next_random(uint32_t* state_ptr)
+{
+    // xorshift32
+    uint32_t x = *state_ptr;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state_ptr = x;
+    return x;
+}
+
+// Runs the readers and the writer for the time and returns the total gets per second
+static double run(htui32_concurrent_t* ht_ptr, uint32_t readers_count)
+{
+    std::atomic<bool> stop(false);
+    std::vector<uint64_t> gets_counts(readers_count);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < readers_count; ++t) {
+        threads.emplace_back([=, &stop, &gets_counts]() {
+            uint32_t state = 0x9e3779b9 * (t + 1);
+            uint64_t gets_count = 0;
+            uint32_t found_count = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (uint32_t i = 0; i < 1024; ++i) {
+                    uint32_t key = (next_random(&state) % keys_count + 1) * 4096;
+                    found_count += htui32_concurrent_get(ht_ptr, key, NULL) ? 1 : 0;
+                }
+                gets_count += 1024;
+            }
+            gets_counts[t] = gets_count;
+            found_sink += found_count;
+        });
+    }
+    std::thread writer([=, &stop]() {
+        uint32_t state = 12345;
+        while (!stop.load(std::memory_order_relaxed)) {
+            // Half of the keys goes away and comes back, the table shrinks and grows
+            for (uint32_t i = 1; i <= keys_count && !stop.load(std::memory_order_relaxed); i += 4) {
+                htui32_concurrent_delete(ht_ptr, i * 4096);
+            }
+            for (uint32_t i = 1; i <= keys_count && !stop.load(std::memory_order_relaxed); i += 4) {
+                htui32_concurrent_put(ht_ptr, i * 4096, next_random(&state));
+            }
+        }
+    });
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+    stop.store(true);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    std::chrono::duration<double> seconds = std::chrono::steady_clock::now() - start;
+    writer.join();
+    uint64_t gets_count = 0;
+    for (uint64_t count : gets_counts) {
+        gets_count += count;
+    }
+    return (double)gets_count / seconds.count();
+}
+
+static double run_config(bool read_mostly, uint32_t readers_count)
+{
+    htui32_concurrent_t ht;
+    htui32_concurrent_config_t config = {};
+    config.read_mostly = read_mostly;
+    // Deleting half of the keys shrinks the table once and putting them back grows it once
+    config.load_fac_min = 30;
+    htui32_concurrent_init(&ht, &config);
+    for (uint32_t i = 1; i <= keys_count; i += 2) {
+        htui32_concurrent_put(&ht, i * 4096, i);
+    }
+    double gets_per_second = run(&ht, readers_count);
+    htui32_concurrent_destroy(&ht);
+    return gets_per_second;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1) {
+        keys_count = (uint32_t)strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2) {
+        milliseconds = (uint32_t)strtoul(argv[2], NULL, 10);
+    }
+    uint32_t max_threads = std::thread::hardware_concurrency();
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+    printf("keys %u, %u ms per run, 1 writer thread\n", keys_count, milliseconds);
+    printf("%8s %18s %18s %10s\n", "readers", "locked Mgets/s", "lockless Mgets/s", "scaling");
+
+    double single_reader_gets = 0;
+    for (uint32_t readers_count = 1; ; readers_count *= 2) {
+        if (readers_count > max_threads) {
+            readers_count = max_threads;
+        }
+        double locked_gets = run_config(false, readers_count);
+        double lockless_gets = run_config(true, readers_count);
+        if (readers_count == 1) {
+            single_reader_gets = lockless_gets;
+        }
+        printf("%8u %18.2f %18.2f %9.2fx\n", readers_count, locked_gets / 1e6, lockless_gets / 1e6, lockless_gets / single_reader_gets);
+        if (readers_count == max_threads) {
+            break;
+        }
+    }
+    return 0;
+}
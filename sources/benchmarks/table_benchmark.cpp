@@ -0,0 +1,302 @@
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../hash_table_uint32/hash_table_uint32.h"
+#include "../hash_table_uint32/hash_table_uint32.hpp"
+
+/*
+ * Throughput of put, get of present keys (hit), get of absent keys (miss) and delete
+ * for every table mode, the C++ template table and std::unordered_map as a baseline, with 32-bit and 64-bit keys and values,
+ * across table sizes from L1-resident to far beyond the last level cache, load factor limits and key distributions.
+ *
+ * Usage: table_benchmark [max_keys] [filter]
+ * max_keys - the largest table size (default 4M keys, the sizes go from 1K keys in steps of 16x)
+ * filter - only rows whose table or distribution name contains this string are run
+ */
+
+// Every measurement makes at least this many operations, small tables are measured several times
+static const size_t min_ops_count = 1 << 22;
+
+struct load_limits_t {
+    uint8_t load_fac_min;
+    uint8_t load_fac_max;
+};
+
+static const load_limits_t load_limits[] = { { 10, 50 }, { 25, 75 }, { 40, 90 } };
+
+enum distribution_t {
+    DISTRIBUTION_SEQUENTIAL,
+    DISTRIBUTION_RANDOM,
+    // Page aligned addresses, like the keys of the SLAB allocator, there are only 2^20 of them
+    DISTRIBUTION_PAGE_ALIGNED
+};
+
+static const char* distribution_names[] = { "sequential", "random", "page" };
+
+// Key number i of the distribution, all keys are unique, keys of i >= count are used for misses
+static uint32_t make_key(distribution_t distribution, uint32_t i)
+{
+    switch (distribution) {
+    case DISTRIBUTION_RANDOM:
+        // Multiplication by an odd number is a bijection, so the keys stay unique
+        return (i * 0x2545f491u) ^ 0x6b43a9b5u;
+    case DISTRIBUTION_PAGE_ALIGNED:
+        return i * 4096;
+    default:
+        return i + 1;
+    }
+}
+
+// The tables compared, each one is used through the same three operations
+struct htui32_table_t {
+    hash_table_uint32_t ht;
+    htui32_table_t(htui32_mode_t mode, load_limits_t limits)
+    {
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.mode = mode;
+        config.load_fac_min = limits.load_fac_min;
+        config.load_fac_max = limits.load_fac_max;
+        htui32_init_ex(&ht, &config);
+    }
+    ~htui32_table_t() { htui32_destroy(&ht); }
+    void put(uint32_t key, uint32_t value) { htui32_put(&ht, key, value); }
+    bool get(uint32_t key, uint32_t* value_ptr) { return htui32_get(&ht, key, value_ptr); }
+    void del(uint32_t key) { htui32_delete(&ht, key); }
+};
+
+struct template_table_t {
+    htui32::HashTable<uint32_t, uint32_t> ht;
+    template_table_t(htui32_mode_t mode, load_limits_t limits) : ht(4, limits.load_fac_min, limits.load_fac_max) { (void)mode; }
+    void put(uint32_t key, uint32_t value) { ht.put(key, value); }
+    bool get(uint32_t key, uint32_t* value_ptr) { return ht.get(key, value_ptr); }
+    void del(uint32_t key) { ht.erase(key); }
+};
+
+// 64-bit key of the 32-bit key, like the address of an object of 64 bytes
+static inline uint64_t widen_key(uint32_t key)
+{
+    return 0x00007f0000000000ull + ((uint64_t)key << 6);
+}
+
+struct template64_table_t {
+    htui32::HashTableUInt64 ht;
+    template64_table_t(htui32_mode_t mode, load_limits_t limits) : ht(4, limits.load_fac_min, limits.load_fac_max) { (void)mode; }
+    void put(uint32_t key, uint32_t value) { ht.put(widen_key(key), value); }
+    bool get(uint32_t key, uint32_t* value_ptr)
+    {
+        const uint64_t* item_value_ptr = ht.find(widen_key(key));
+        if (item_value_ptr == nullptr) {
+            return false;
+        }
+        *value_ptr = (uint32_t)*item_value_ptr;
+        return true;
+    }
+    void del(uint32_t key) { ht.erase(widen_key(key)); }
+};
+
+struct unordered_map64_table_t {
+    std::unordered_map<uint64_t, uint64_t> map;
+    unordered_map64_table_t(htui32_mode_t mode, load_limits_t limits)
+    {
+        (void)mode;
+        map.max_load_factor(limits.load_fac_max / 100.0f);
+    }
+    void put(uint32_t key, uint32_t value) { map[widen_key(key)] = value; }
+    bool get(uint32_t key, uint32_t* value_ptr)
+    {
+        auto it = map.find(widen_key(key));
+        if (it == map.end()) {
+            return false;
+        }
+        *value_ptr = (uint32_t)it->second;
+        return true;
+    }
+    void del(uint32_t key) { map.erase(widen_key(key)); }
+};
+
+struct unordered_map_table_t {
+    std::unordered_map<uint32_t, uint32_t> map;
+    unordered_map_table_t(htui32_mode_t mode, load_limits_t limits)
+    {
+        (void)mode;
+        map.max_load_factor(limits.load_fac_max / 100.0f);
+    }
+    void put(uint32_t key, uint32_t value) { map[key] = value; }
+    bool get(uint32_t key, uint32_t* value_ptr)
+    {
+        auto it = map.find(key);
+        if (it == map.end()) {
+            return false;
+        }
+        *value_ptr = it->second;
+        return true;
+    }
+    void del(uint32_t key) { map.erase(key); }
+};
+
+struct results_t {
+    double put_ns;
+    double get_hit_ns;
+    double get_miss_ns;
+    double delete_ns;
+};
+
+static double elapsed_ns(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Sink for the results, so that the compiler does not drop the gets
+static volatile uint32_t sink;
+
+template <typename Table>
+static results_t measure(htui32_mode_t mode, load_limits_t limits, const std::vector<uint32_t>& keys,
+    const std::vector<uint32_t>& shuffled_keys, const std::vector<uint32_t>& miss_keys)
+{
+    size_t rounds = std::max<size_t>(1, min_ops_count / keys.size());
+    double ops = (double)rounds * keys.size();
+    results_t results = {};
+    uint32_t acc = 0;
+    for (size_t round = 0; round < rounds; ++round) {
+        Table table(mode, limits);
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t key : keys) {
+            table.put(key, key);
+        }
+        results.put_ns += elapsed_ns(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t key : shuffled_keys) {
+            uint32_t value = 0;
+            table.get(key, &value);
+            acc += value;
+        }
+        results.get_hit_ns += elapsed_ns(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t key : miss_keys) {
+            uint32_t value = 0;
+            acc += table.get(key, &value) ? 1 : 0;
+        }
+        results.get_miss_ns += elapsed_ns(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t key : shuffled_keys) {
+            table.del(key);
+        }
+        results.delete_ns += elapsed_ns(start);
+    }
+    sink = acc;
+    results.put_ns /= ops;
+    results.get_hit_ns /= ops;
+    results.get_miss_ns /= ops;
+    results.delete_ns /= ops;
+    return results;
+}
+
+static void print_results(const char* table_name, const char* distribution_name, size_t keys_count, load_limits_t limits, results_t results)
+{
+    printf("%-15s %-10s %9zu %3u/%-3u   %7.2f %7.2f  %7.2f %7.2f  %7.2f %7.2f  %7.2f %7.2f\n",
+        table_name, distribution_name, keys_count, limits.load_fac_min, limits.load_fac_max,
+        results.put_ns, 1e3 / results.put_ns,
+        results.get_hit_ns, 1e3 / results.get_hit_ns,
+        results.get_miss_ns, 1e3 / results.get_miss_ns,
+        results.delete_ns, 1e3 / results.delete_ns);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv)
+{
+    size_t max_keys = 1 << 22;
+    if (argc > 1) {
+        max_keys = (size_t)strtoull(argv[1], NULL, 10);
+    }
+    std::string filter = (argc > 2) ? argv[2] : "";
+
+    enum table_kind_t {
+        TABLE_HTUI32,
+        TABLE_TEMPLATE,
+        TABLE_UNORDERED_MAP,
+        // 64-bit keys and values
+        TABLE_TEMPLATE64,
+        TABLE_UNORDERED_MAP64
+    };
+    struct {
+        const char* name;
+        table_kind_t kind;
+        htui32_mode_t mode;
+    } modes[] = {
+        { "chaining", TABLE_HTUI32, HTUI32_MODE_CHAINING },
+        { "compact", TABLE_HTUI32, HTUI32_MODE_COMPACT_CHAINING },
+        { "cuckoo", TABLE_HTUI32, HTUI32_MODE_CUCKOO },
+        { "linear", TABLE_HTUI32, HTUI32_MODE_LINEAR_PROBING },
+        { "robin_hood", TABLE_HTUI32, HTUI32_MODE_ROBIN_HOOD },
+        { "swiss", TABLE_HTUI32, HTUI32_MODE_SWISS },
+        { "template", TABLE_TEMPLATE, HTUI32_MODE_DEFAULT },
+        { "unordered_map", TABLE_UNORDERED_MAP, HTUI32_MODE_DEFAULT },
+        { "template64", TABLE_TEMPLATE64, HTUI32_MODE_DEFAULT },
+        { "unordered_map64", TABLE_UNORDERED_MAP64, HTUI32_MODE_DEFAULT },
+    };
+
+    printf("%-15s %-10s %9s %7s   %15s  %15s  %15s  %15s\n", "", "", "", "load", "put", "get hit", "get miss", "delete");
+    printf("%-15s %-10s %9s %7s   %7s %7s  %7s %7s  %7s %7s  %7s %7s\n", "table", "keys", "size", "min/max",
+        "ns/op", "Mops/s", "ns/op", "Mops/s", "ns/op", "Mops/s", "ns/op", "Mops/s");
+
+    std::mt19937 random_engine(1);
+    for (size_t keys_count = 1 << 10; keys_count <= max_keys; keys_count *= 16) {
+        for (int d = DISTRIBUTION_SEQUENTIAL; d <= DISTRIBUTION_PAGE_ALIGNED; ++d) {
+            distribution_t distribution = (distribution_t)d;
+            // Hits and misses together must fit into the 2^20 page aligned keys
+            if (distribution == DISTRIBUTION_PAGE_ALIGNED && keys_count * 2 > ((size_t)1 << 20)) {
+                continue;
+            }
+            std::vector<uint32_t> keys(keys_count);
+            std::vector<uint32_t> miss_keys(keys_count);
+            for (size_t i = 0; i < keys_count; ++i) {
+                keys[i] = make_key(distribution, (uint32_t)i);
+                miss_keys[i] = make_key(distribution, (uint32_t)(keys_count + i));
+            }
+            // The keys are put in their order and looked up and deleted in random order
+            std::vector<uint32_t> shuffled_keys = keys;
+            std::shuffle(shuffled_keys.begin(), shuffled_keys.end(), random_engine);
+            std::shuffle(miss_keys.begin(), miss_keys.end(), random_engine);
+
+            for (const auto& mode : modes) {
+                if (!filter.empty() && std::string(mode.name).find(filter) == std::string::npos
+                    && std::string(distribution_names[d]).find(filter) == std::string::npos) {
+                    continue;
+                }
+                for (const load_limits_t& limits : load_limits) {
+                    results_t results = {};
+                    switch (mode.kind) {
+                    case TABLE_HTUI32:
+                        results = measure<htui32_table_t>(mode.mode, limits, keys, shuffled_keys, miss_keys);
+                        break;
+                    case TABLE_TEMPLATE:
+                        results = measure<template_table_t>(mode.mode, limits, keys, shuffled_keys, miss_keys);
+                        break;
+                    case TABLE_UNORDERED_MAP:
+                        results = measure<unordered_map_table_t>(mode.mode, limits, keys, shuffled_keys, miss_keys);
+                        break;
+                    case TABLE_TEMPLATE64:
+                        results = measure<template64_table_t>(mode.mode, limits, keys, shuffled_keys, miss_keys);
+                        break;
+                    case TABLE_UNORDERED_MAP64:
+                        results = measure<unordered_map64_table_t>(mode.mode, limits, keys, shuffled_keys, miss_keys);
+                        break;
+                    }
+                    print_results(mode.name, distribution_names[d], keys_count, limits, results);
+                }
+            }
+        }
+    }
+    return 0;
+}
@@ -1,11 +1,70 @@
-#include "hash_table_uint32.h"
-#include "murmur_hash3/murmur_hash3.h"
+#include "hash_table_uint32_internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 
-#define alloc_func(size) malloc(size)
-#define free_func(ptr) free(ptr)
+static void* default_alloc(void* context, size_t size)
+{
+    (void)context;
+    return malloc(size);
+}
+
+static void default_free(void* context, void* ptr, size_t size)
+{
+    (void)context;
+    (void)size;
+    free(ptr);
+}
+
+const htui32_allocator_t htui32_default_allocator = { default_alloc, default_free, NULL };
+
+// Puts, deletes and resizing change only a usable table (capacity is not 0) that is not a mapped snapshot or a frozen table
+static bool is_writable(hash_table_uint32_t* ht_ptr)
+{
+    return ht_ptr != NULL && ht_ptr->capacity != 0 && ht_ptr->mode != HTUI32_MODE_SNAPSHOT && ht_ptr->mode != HTUI32_MODE_FROZEN;
+}
+
+// The Swiss table and cuckoo modes and the mask reduction need a power of two capacity
+static bool capacity_is_power_of_two(hash_table_uint32_t* ht_ptr)
+{
+    return ht_ptr->mode == HTUI32_MODE_SWISS || ht_ptr->mode == HTUI32_MODE_CUCKOO || ht_ptr->reduction == HTUI32_REDUCTION_MASK;
+}
+
+// Rounds the capacity up to a capacity the mode and the reduction of the table can use
+static size_t round_capacity(hash_table_uint32_t* ht_ptr, size_t capacity)
+{
+    if (ht_ptr->mode == HTUI32_MODE_SWISS) {
+        return htui32_swiss_round_capacity(capacity);
+    }
+    if (ht_ptr->mode == HTUI32_MODE_CUCKOO) {
+        return htui32_cuckoo_round_capacity(capacity);
+    }
+    if (ht_ptr->reduction == HTUI32_REDUCTION_MASK) {
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded *= 2;
+        }
+        return rounded;
+    }
+    return capacity;
+}
+
+// Capacity the table grows to, a power of two capacity always doubles
+static size_t grown_capacity(hash_table_uint32_t* ht_ptr)
+{
+    if (capacity_is_power_of_two(ht_ptr)) {
+        return ht_ptr->capacity * 2;
+    }
+    size_t new_capacity = ht_ptr->capacity * ht_ptr->growth_fac / 100;
+    return (new_capacity > ht_ptr->capacity) ? new_capacity : ht_ptr->capacity + 1;
+}
+
+// Capacity the table shrinks to, it is never less than the initial capacity
+static size_t shrunk_capacity(hash_table_uint32_t* ht_ptr)
+{
+    size_t new_capacity = capacity_is_power_of_two(ht_ptr) ? ht_ptr->capacity / 2 : ht_ptr->capacity * 100 / ht_ptr->growth_fac;
+    return (new_capacity > ht_ptr->initial_capacity) ? new_capacity : ht_ptr->initial_capacity;
+}
 
 static void calculate_rehash_sizes(hash_table_uint32_t* ht_ptr)
 {
@@ -16,6 +75,28 @@ static void calculate_rehash_sizes(hash_table_uint32_t* ht_ptr)
     ht_ptr->rehash_max_size = (ht_ptr->capacity * ht_ptr->load_fac_max + 99) / 100;
     // Round down
     ht_ptr->rehash_min_size = (ht_ptr->capacity * ht_ptr->load_fac_min) / 100;
+    // Hysteresis: the load after shrinking must stay load_fac_hysteresis below load_fac_max,
+    // otherwise the next put would grow the table back (it happens when load_fac_min is close to load_fac_max / growth factor)
+    size_t shrunk_load_fac_max = (ht_ptr->load_fac_max > ht_ptr->load_fac_hysteresis) ? ht_ptr->load_fac_max - ht_ptr->load_fac_hysteresis : 0;
+    size_t shrunk_max_size = (shrunk_capacity(ht_ptr) * shrunk_load_fac_max) / 100;
+    if (shrunk_max_size < ht_ptr->rehash_min_size) {
+        ht_ptr->rehash_min_size = shrunk_max_size;
+    }
+}
+
+/*
+ * Returns the first item of the collision chain in which the key with the hash is located or must be placed
+ * During incremental rehashing the keys of the old buckets that are not moved yet stay in the old memory
+ */
+static hash_table_uint32_item_t* get_bucket(hash_table_uint32_t* ht_ptr, uint32_t hash)
+{
+    if (ht_ptr->old_memory_ptr != NULL) {
+        size_t old_pos = htui32_reduce(ht_ptr, hash, ht_ptr->old_capacity);
+        if (old_pos >= ht_ptr->rehash_pos) {
+            return &ht_ptr->old_memory_ptr[old_pos];
+        }
+    }
+    return &ht_ptr->memory_ptr[htui32_reduce(ht_ptr, hash, ht_ptr->capacity)];
 }
 
 /*
@@ -25,20 +106,18 @@ static void calculate_rehash_sizes(hash_table_uint32_t* ht_ptr)
  * 
  * Returns true if the key is found, otherwise false
  */
-static bool find_item_by_key(hash_table_uint32_t* ht_ptr, uint32_t key, hash_table_uint32_item_t** item_ptr, hash_table_uint32_item_t** prev_item_ptr, hash_table_uint32_item_t** next_item_ptr)
+static bool find_item_by_key(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, hash_table_uint32_item_t** item_ptr, hash_table_uint32_item_t** prev_item_ptr, hash_table_uint32_item_t** next_item_ptr)
 {
     if (key == 0) {
         return false;
     }
 
-    uint32_t hash = 0;
-    MurmurHash3_x86_32(&key, sizeof(key), 0, &hash);
-    uint32_t pos = hash % ht_ptr->capacity;
-
     // Try to find key
-    hash_table_uint32_item_t* current_item = &ht_ptr->memory_ptr[pos];
+    hash_table_uint32_item_t* current_item = get_bucket(ht_ptr, hash);
     hash_table_uint32_item_t* prev_item = NULL;
+    HTUI32_COUNT(ht_ptr, lookups_count, 1);
     while (current_item != NULL) {
+        HTUI32_COUNT(ht_ptr, probe_steps_count, 1);
         if (current_item->key == key) {
             // Key is found
             if (item_ptr != NULL) {
@@ -62,190 +141,634 @@ static bool find_item_by_key(hash_table_uint32_t* ht_ptr, uint32_t key, hash_tab
     return false;
 }
 
-static void check_and_grow_rehash(hash_table_uint32_t* ht_ptr)
+/*
+ * Puts a new item to the bucket without walking its collision chain, the key must not be in the table
+ * The item is linked right after the first item of the bucket, the order of a chain does not matter
+ * Returns a pointer to the value of the item or NULL if the memory for the collision chain item could not be allocated
+ */
+static uint32_t* bucket_insert(hash_table_uint32_t* ht_ptr, hash_table_uint32_item_t* bucket, uint32_t key, uint32_t value)
 {
-    calculate_rehash_sizes(ht_ptr);
-    if (ht_ptr->size + 1 >= ht_ptr->rehash_max_size) {
-        // Alloc new memory
-        hash_table_uint32_item_t* new_memory = alloc_func((ht_ptr->capacity * 2) * sizeof(hash_table_uint32_item_t));
-        if (new_memory == NULL) {
-            return;
+    if (bucket->key == 0) {
+        bucket->key = key;
+        bucket->value = value;
+        return &bucket->value;
+    }
+    hash_table_uint32_item_t* new_item = htui32_pool_take(&ht_ptr->item_pool, &ht_ptr->allocator);
+    if (new_item == NULL) {
+        return NULL;
+    }
+    new_item->key = key;
+    new_item->value = value;
+    new_item->next = bucket->next;
+    bucket->next = new_item;
+    return &new_item->value;
+}
+
+// Puts a new item without walking the collision chain, returns false if the memory could not be allocated
+static bool chaining_insert_unique(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value)
+{
+    return bucket_insert(ht_ptr, get_bucket(ht_ptr, hash), key, value) != NULL;
+}
+
+// Same as htui32_open_find_or_insert, the collision chain is walked once and a missing key is linked to its bucket
+static uint32_t* chaining_find_or_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, bool* is_inserted_ptr)
+{
+    hash_table_uint32_item_t* bucket = get_bucket(ht_ptr, hash);
+    HTUI32_COUNT(ht_ptr, lookups_count, 1);
+    for (hash_table_uint32_item_t* current_item = bucket; current_item != NULL; current_item = current_item->next) {
+        HTUI32_COUNT(ht_ptr, probe_steps_count, 1);
+        if (current_item->key == key) {
+            return &current_item->value;
         }
-        hash_table_uint32_item_t* old_memory = ht_ptr->memory_ptr;
-        size_t old_capacity = ht_ptr->capacity;
-        ht_ptr->capacity = old_capacity * 2;
-        ht_ptr->memory_ptr = new_memory;
-        ht_ptr->memory_size *= 2;
-        ht_ptr->size = 0;
-        memset(ht_ptr->memory_ptr, 0, ht_ptr->memory_size);
-        // Copy items to new hash table
-        for (size_t i = 0; i < old_capacity; ++i) {
-            // Going through all the elements in the current collision chain
-            hash_table_uint32_item_t* current_item = &old_memory[i];
-            hash_table_uint32_item_t* next_item = old_memory[i].next;
-            while (current_item != NULL) {
-                if (current_item->key != 0) {
-                    htui32_put(ht_ptr, current_item->key, current_item->value);
-                    // Free memory allocated for the collision chain element (but not for the first one)
-                    if (current_item != &old_memory[i]) {
-                        free_func(current_item);
-                    }
-                }
-                current_item = next_item;
-                if (current_item != NULL) {
-                    next_item = current_item->next;
-                }
+    }
+    uint32_t* value_ptr = bucket_insert(ht_ptr, bucket, key, value);
+    *is_inserted_ptr = value_ptr != NULL;
+    return value_ptr;
+}
+
+/*
+ * Removes the key from its collision chain
+ * Returns false if the key is not in the table
+ */
+static bool chaining_remove(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    hash_table_uint32_item_t* item = NULL;
+    hash_table_uint32_item_t* prev_item = NULL;
+    hash_table_uint32_item_t* next_item = NULL;
+    if (!find_item_by_key(ht_ptr, key, hash, &item, &prev_item, &next_item)) {
+        return false;
+    }
+    // Is first in collision chain?
+    if (prev_item == NULL) {
+        // Clear key and value
+        item->key = 0;
+        item->value = 0;
+    }
+    else {
+        prev_item->next = next_item;
+        htui32_pool_release(&ht_ptr->item_pool, item);
+    }
+    return true;
+}
+
+// Returns the bucket of the current memory the key is moved to during rehashing
+static inline hash_table_uint32_item_t* new_bucket(hash_table_uint32_t* ht_ptr, uint32_t key)
+{
+    return &ht_ptr->memory_ptr[htui32_reduce(ht_ptr, htui32_hash(key), ht_ptr->capacity)];
+}
+
+/*
+ * Returns true if the first key of old_bucket needs an item from the item pool that no collision chain item of old_bucket releases:
+ * every key of old_bucket lands in a used bucket, an item that lands in a free bucket would be released before the first key is moved
+ */
+static bool bucket_move_needs_item(hash_table_uint32_t* ht_ptr, hash_table_uint32_item_t* old_bucket)
+{
+    if (old_bucket->key == 0 || new_bucket(ht_ptr, old_bucket->key)->key == 0) {
+        return false;
+    }
+    for (hash_table_uint32_item_t* current_item = old_bucket->next; current_item != NULL; current_item = current_item->next) {
+        if (new_bucket(ht_ptr, current_item->key)->key == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Moves all items of the collision chain starting with old_bucket to the current memory
+ * Keys are unique, so the items are linked right after the first item of their new bucket without lookup.
+ * Collision chain items are relinked instead of being copied: an item that lands in a free bucket
+ * is released to the item pool, which is used when the first item of old_bucket
+ * (which is a part of the old memory) lands in a used bucket.
+ * Returns false if the memory for that item could not be allocated, nothing is moved then
+ */
+static bool move_bucket(hash_table_uint32_t* ht_ptr, hash_table_uint32_item_t* old_bucket)
+{
+    // An item that no chain item releases is taken before anything is moved, so a failed allocation cannot drop the key
+    hash_table_uint32_item_t* head_item = NULL;
+    if (bucket_move_needs_item(ht_ptr, old_bucket)) {
+        head_item = htui32_pool_take(&ht_ptr->item_pool, &ht_ptr->allocator);
+        if (head_item == NULL) {
+            return false;
+        }
+    }
+    hash_table_uint32_item_t* current_item = old_bucket->next;
+    while (current_item != NULL) {
+        hash_table_uint32_item_t* next_item = current_item->next;
+        hash_table_uint32_item_t* bucket = new_bucket(ht_ptr, current_item->key);
+        if (bucket->key == 0) {
+            bucket->key = current_item->key;
+            bucket->value = current_item->value;
+            htui32_pool_release(&ht_ptr->item_pool, current_item);
+        }
+        else {
+            current_item->next = bucket->next;
+            bucket->next = current_item;
+        }
+        current_item = next_item;
+    }
+    if (old_bucket->key != 0) {
+        hash_table_uint32_item_t* bucket = new_bucket(ht_ptr, old_bucket->key);
+        if (bucket->key == 0) {
+            bucket->key = old_bucket->key;
+            bucket->value = old_bucket->value;
+        }
+        else {
+            // Released items are taken first, so it is the item released above and no memory is allocated
+            if (head_item == NULL) {
+                head_item = htui32_pool_take(&ht_ptr->item_pool, &ht_ptr->allocator);
             }
+            head_item->key = old_bucket->key;
+            head_item->value = old_bucket->value;
+            head_item->next = bucket->next;
+            bucket->next = head_item;
         }
-        if (ht_ptr->zero_key_is_used) {
-            ht_ptr->size++;
+    }
+    old_bucket->next = NULL;
+    old_bucket->key = 0;
+    old_bucket->value = 0;
+    return true;
+}
+
+/*
+ * Clears or moves up to buckets_count buckets during incremental rehashing: the current memory is cleared first,
+ * then the buckets of the old memory are moved to it. The old memory is freed after its last bucket is moved
+ * Returns false if a bucket could not be moved, it stays in the old memory and the next step tries it again
+ */
+static bool chaining_rehash_step(hash_table_uint32_t* ht_ptr, size_t buckets_count)
+{
+    if (ht_ptr->old_memory_ptr != NULL && ht_ptr->cleared_count < ht_ptr->capacity) {
+        size_t clear_count = ht_ptr->capacity - ht_ptr->cleared_count;
+        clear_count = (clear_count < buckets_count) ? clear_count : buckets_count;
+        memset(&ht_ptr->memory_ptr[ht_ptr->cleared_count], 0, clear_count * sizeof(hash_table_uint32_item_t));
+        ht_ptr->cleared_count += clear_count;
+        buckets_count -= clear_count;
+    }
+    while (ht_ptr->old_memory_ptr != NULL && buckets_count > 0) {
+        if (!move_bucket(ht_ptr, &ht_ptr->old_memory_ptr[ht_ptr->rehash_pos])) {
+            return false;
+        }
+        ht_ptr->rehash_pos++;
+        buckets_count--;
+        if (ht_ptr->rehash_pos == ht_ptr->old_capacity) {
+            free_func(ht_ptr, ht_ptr->old_memory_ptr, ht_ptr->old_capacity * sizeof(hash_table_uint32_item_t));
+            ht_ptr->old_memory_ptr = NULL;
+            ht_ptr->old_capacity = 0;
+            ht_ptr->rehash_pos = 0;
+        }
+    }
+    return true;
+}
+
+/*
+ * Returns the number of buckets each put and delete clears or moves during the incremental rehashing to the current capacity,
+ * so it is done before the size reaches the next growth or shrink threshold: the fewer puts (deletes) are left until then
+ * (a growth factor close to 100), the more buckets each of them clears or moves
+ */
+static size_t rehash_step_size(hash_table_uint32_t* ht_ptr)
+{
+    calculate_rehash_sizes(ht_ptr);
+    // Steps until the put or delete that reaches the threshold, it makes a step before rehashing, the step of this operation is counted too
+    size_t steps_count = (ht_ptr->rehash_max_size > ht_ptr->size) ? ht_ptr->rehash_max_size - ht_ptr->size : 1;
+    if (ht_ptr->auto_shrink) {
+        size_t shrink_steps_count = (ht_ptr->size >= ht_ptr->rehash_min_size) ? ht_ptr->size - ht_ptr->rehash_min_size + 1 : 1;
+        steps_count = (shrink_steps_count < steps_count) ? shrink_steps_count : steps_count;
+    }
+    size_t buckets_count = ht_ptr->capacity + ht_ptr->old_capacity;
+    size_t step = (buckets_count + steps_count - 1) / steps_count;
+    return (step > HTUI32_INCREMENTAL_REHASH_STEP) ? step : HTUI32_INCREMENTAL_REHASH_STEP;
+}
+
+/*
+ * Moves all items to the new memory with new_capacity buckets
+ * With incremental rehashing the new memory is cleared and the items are moved by this and the following puts and deletes
+ * Returns false if the memory could not be allocated, the table is left unchanged in this case
+ */
+static bool chaining_rehash(hash_table_uint32_t* ht_ptr, size_t new_capacity)
+{
+    // Previous incremental rehashing must be completed first, there are only two memories at a time.
+    // The rehashing started by a growth or shrinking is already done by then, only htui32_reserve and htui32_compact get here before
+    if (!chaining_rehash_step(ht_ptr, SIZE_MAX)) {
+        return false;
+    }
+    // Alloc new memory
+    hash_table_uint32_item_t* new_memory = alloc_func(ht_ptr, new_capacity * sizeof(hash_table_uint32_item_t));
+    if (new_memory == NULL) {
+        return false;
+    }
+    hash_table_uint32_item_t* old_memory = ht_ptr->memory_ptr;
+    size_t old_capacity = ht_ptr->capacity;
+    ht_ptr->capacity = new_capacity;
+    ht_ptr->memory_ptr = new_memory;
+    ht_ptr->memory_size = new_capacity * sizeof(hash_table_uint32_item_t);
+    if (old_memory != NULL && ht_ptr->incremental_rehash) {
+        // The keys stay in the old memory until the new one is cleared
+        ht_ptr->old_memory_ptr = old_memory;
+        ht_ptr->old_capacity = old_capacity;
+        ht_ptr->rehash_pos = 0;
+        ht_ptr->cleared_count = 0;
+        ht_ptr->rehash_step = rehash_step_size(ht_ptr);
+        chaining_rehash_step(ht_ptr, ht_ptr->rehash_step);
+        return true;
+    }
+    memset(ht_ptr->memory_ptr, 0, ht_ptr->memory_size);
+    ht_ptr->cleared_count = new_capacity;
+    if (old_memory == NULL) {
+        return true;
+    }
+    // Copy items to new hash table, if a bucket cannot be moved the rest of them are moved incrementally,
+    // they are found in the old memory until then
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (!move_bucket(ht_ptr, &old_memory[i])) {
+            ht_ptr->old_memory_ptr = old_memory;
+            ht_ptr->old_capacity = old_capacity;
+            ht_ptr->rehash_pos = i;
+            return true;
+        }
+    }
+    free_func(ht_ptr, old_memory, old_capacity * sizeof(hash_table_uint32_item_t));
+    return true;
+}
+
+static uint32_t* find_value(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    switch (ht_ptr->mode) {
+    case HTUI32_MODE_LINEAR_PROBING:
+    case HTUI32_MODE_ROBIN_HOOD:
+        return htui32_open_find(ht_ptr, key, hash);
+    case HTUI32_MODE_SWISS:
+        return htui32_swiss_find(ht_ptr, key, hash);
+    case HTUI32_MODE_SNAPSHOT:
+        return htui32_snapshot_find(ht_ptr, key, hash);
+    case HTUI32_MODE_FROZEN:
+        return htui32_frozen_find(ht_ptr, key, hash);
+    case HTUI32_MODE_COMPACT_CHAINING:
+        return htui32_compact_chaining_find(ht_ptr, key, hash);
+    case HTUI32_MODE_CUCKOO:
+        return htui32_cuckoo_find(ht_ptr, key, hash);
+    default: {
+        hash_table_uint32_item_t* item = NULL;
+        if (find_item_by_key(ht_ptr, key, hash, &item, NULL, NULL)) {
+            return &item->value;
+        }
+        return NULL;
+    }
+    }
+}
+
+// Returns a pointer to the value of the key, a missing key is put with value first, the key must not be 0
+static uint32_t* find_or_insert_item(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, bool* is_inserted_ptr)
+{
+    switch (ht_ptr->mode) {
+    case HTUI32_MODE_LINEAR_PROBING:
+    case HTUI32_MODE_ROBIN_HOOD:
+        return htui32_open_find_or_insert(ht_ptr, key, hash, value, is_inserted_ptr);
+    case HTUI32_MODE_SWISS:
+        return htui32_swiss_find_or_insert(ht_ptr, key, hash, value, is_inserted_ptr);
+    case HTUI32_MODE_COMPACT_CHAINING:
+        return htui32_compact_chaining_find_or_insert(ht_ptr, key, hash, value, is_inserted_ptr);
+    case HTUI32_MODE_CUCKOO:
+        return htui32_cuckoo_find_or_insert(ht_ptr, key, hash, value, is_inserted_ptr);
+    default:
+        return chaining_find_or_insert(ht_ptr, key, hash, value, is_inserted_ptr);
+    }
+}
+
+// Puts a new item, the key must not be in the table, the chaining mode does not walk the collision chain
+static bool insert_unique_item(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value)
+{
+    switch (ht_ptr->mode) {
+    case HTUI32_MODE_LINEAR_PROBING:
+    case HTUI32_MODE_ROBIN_HOOD:
+        return htui32_open_insert(ht_ptr, key, hash, value);
+    case HTUI32_MODE_SWISS:
+        return htui32_swiss_insert(ht_ptr, key, hash, value);
+    case HTUI32_MODE_COMPACT_CHAINING:
+        return htui32_compact_chaining_insert(ht_ptr, key, hash, value);
+    case HTUI32_MODE_CUCKOO:
+        return htui32_cuckoo_insert(ht_ptr, key, hash, value);
+    default:
+        return chaining_insert_unique(ht_ptr, key, hash, value);
+    }
+}
+
+static bool remove_item(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    switch (ht_ptr->mode) {
+    case HTUI32_MODE_LINEAR_PROBING:
+    case HTUI32_MODE_ROBIN_HOOD:
+        return htui32_open_remove(ht_ptr, key, hash);
+    case HTUI32_MODE_SWISS:
+        return htui32_swiss_remove(ht_ptr, key, hash);
+    case HTUI32_MODE_COMPACT_CHAINING:
+        return htui32_compact_chaining_remove(ht_ptr, key, hash);
+    case HTUI32_MODE_CUCKOO:
+        return htui32_cuckoo_remove(ht_ptr, key, hash);
+    default:
+        return chaining_remove(ht_ptr, key, hash);
+    }
+}
+
+// Hints the processor to load the memory where the key with the hash is located
+static void prefetch_item(hash_table_uint32_t* ht_ptr, uint32_t hash)
+{
+    switch (ht_ptr->mode) {
+    case HTUI32_MODE_LINEAR_PROBING:
+    case HTUI32_MODE_ROBIN_HOOD:
+        htui32_open_prefetch(ht_ptr, hash);
+        break;
+    case HTUI32_MODE_SWISS:
+        htui32_swiss_prefetch(ht_ptr, hash);
+        break;
+    case HTUI32_MODE_SNAPSHOT:
+        htui32_snapshot_prefetch(ht_ptr, hash);
+        break;
+    case HTUI32_MODE_FROZEN:
+        htui32_frozen_prefetch(ht_ptr, hash);
+        break;
+    case HTUI32_MODE_COMPACT_CHAINING:
+        htui32_compact_chaining_prefetch(ht_ptr, hash);
+        break;
+    case HTUI32_MODE_CUCKOO:
+        htui32_cuckoo_prefetch(ht_ptr, hash);
+        break;
+    default:
+        htui32_prefetch(get_bucket(ht_ptr, hash));
+        break;
+    }
+}
+
+static bool rehash(hash_table_uint32_t* ht_ptr, size_t new_capacity)
+{
+    switch (ht_ptr->mode) {
+    case HTUI32_MODE_LINEAR_PROBING:
+    case HTUI32_MODE_ROBIN_HOOD:
+        return htui32_open_rehash(ht_ptr, new_capacity);
+    case HTUI32_MODE_SWISS:
+        return htui32_swiss_rehash(ht_ptr, new_capacity);
+    case HTUI32_MODE_COMPACT_CHAINING:
+        return htui32_compact_chaining_rehash(ht_ptr, new_capacity);
+    case HTUI32_MODE_CUCKOO:
+        return htui32_cuckoo_rehash(ht_ptr, new_capacity);
+    default:
+        return chaining_rehash(ht_ptr, new_capacity);
+    }
+}
+
+// Clears or moves a few buckets of the incremental rehashing in progress, the time is counted as rehashing time
+static void incremental_rehash_step(hash_table_uint32_t* ht_ptr)
+{
+    if (ht_ptr->old_memory_ptr != NULL) {
+        uint64_t start_ns = htui32_stats_now_ns();
+        chaining_rehash_step(ht_ptr, ht_ptr->rehash_step);
+        HTUI32_COUNT(ht_ptr, rehash_time_ns, htui32_stats_now_ns() - start_ns);
+    }
+}
+
+static void check_and_grow_rehash(hash_table_uint32_t* ht_ptr)
+{
+    calculate_rehash_sizes(ht_ptr);
+    if (ht_ptr->size + 1 >= ht_ptr->rehash_max_size && !ht_ptr->fixed_buffer) {
+        uint64_t start_ns = htui32_stats_now_ns();
+        if (rehash(ht_ptr, grown_capacity(ht_ptr))) {
+            HTUI32_COUNT(ht_ptr, grow_count, 1);
         }
-        free_func(old_memory);
+        HTUI32_COUNT(ht_ptr, rehash_time_ns, htui32_stats_now_ns() - start_ns);
     }
     calculate_rehash_sizes(ht_ptr);
 }
 
 static void check_and_shrink_rehash(hash_table_uint32_t* ht_ptr)
 {
+    if (!ht_ptr->auto_shrink) {
+        return;
+    }
     calculate_rehash_sizes(ht_ptr);
     if (ht_ptr->size <= ht_ptr->rehash_min_size) {
-        if (ht_ptr->capacity / 2 < ht_ptr->initial_capacity) {
+        size_t new_capacity = shrunk_capacity(ht_ptr);
+        if (new_capacity >= ht_ptr->capacity) {
             return;
         }
-        // Alloc new memory
-        hash_table_uint32_item_t* new_memory = alloc_func((ht_ptr->capacity / 2) * sizeof(hash_table_uint32_item_t));
-        if (new_memory == NULL) {
-            return;
-        }
-        hash_table_uint32_item_t* old_memory = ht_ptr->memory_ptr;
-        size_t old_capacity = ht_ptr->capacity;
-        ht_ptr->capacity = old_capacity / 2;
-        ht_ptr->memory_ptr = new_memory;
-        ht_ptr->memory_size /= 2;
-        ht_ptr->size = 0;
-        memset(ht_ptr->memory_ptr, 0, ht_ptr->memory_size);
-        // Copy items to new hash table
-        for (size_t i = 0; i < old_capacity; ++i) {
-            // Going through all the elements in the current collision chain
-            hash_table_uint32_item_t* current_item = &old_memory[i];
-            hash_table_uint32_item_t* next_item = old_memory[i].next;
-            while (current_item != NULL) {
-                if (current_item->key != 0) {
-                    htui32_put(ht_ptr, current_item->key, current_item->value);
-                    // Free memory allocated for the collision chain element (but not for the first one)
-                    if (current_item != &old_memory[i]) {
-                        free_func(current_item);
-                    }
-                }
-                current_item = next_item;
-                if (current_item != NULL) {
-                    next_item = current_item->next;
-                }
-            }
-        }
-        if (ht_ptr->zero_key_is_used) {
-            ht_ptr->size++;
+        uint64_t start_ns = htui32_stats_now_ns();
+        if (rehash(ht_ptr, new_capacity)) {
+            HTUI32_COUNT(ht_ptr, shrink_count, 1);
         }
-        free_func(old_memory);
+        HTUI32_COUNT(ht_ptr, rehash_time_ns, htui32_stats_now_ns() - start_ns);
     }
     calculate_rehash_sizes(ht_ptr);
 }
 
 void htui32_init(hash_table_uint32_t* ht_ptr, size_t capacity, uint8_t load_fac_min, uint8_t load_fac_max)
 {
-    if (ht_ptr == NULL || load_fac_max > 100) {
-        return;
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.capacity = capacity;
+    config.load_fac_min = load_fac_min;
+    config.load_fac_max = load_fac_max;
+    htui32_init_ex(ht_ptr, &config);
+}
+
+/*
+ * Sets up the fields of the empty table without memory (capacity is 0), initial_capacity is the rounded configured capacity
+ * Returns false if the parameters are invalid, the table is not changed then
+ */
+static bool init_fields(hash_table_uint32_t* ht_ptr, const htui32_config_t* config_ptr)
+{
+    if (ht_ptr == NULL || config_ptr->load_fac_max > 100 || (config_ptr->growth_fac != 0 && config_ptr->growth_fac <= 100)
+        || config_ptr->mode == HTUI32_MODE_SNAPSHOT || config_ptr->mode == HTUI32_MODE_FROZEN) {
+        return false;
     }
     // Setup default values
-    ht_ptr->capacity = (capacity != 0 ? capacity : 4);
-    ht_ptr->initial_capacity = ht_ptr->capacity;
+    size_t capacity = (config_ptr->capacity != 0 ? config_ptr->capacity : 4);
+    ht_ptr->mode = (config_ptr->mode != HTUI32_MODE_DEFAULT ? config_ptr->mode : HTUI32_DEFAULT_MODE);
     ht_ptr->size = 0;
-    ht_ptr->load_fac_min = (load_fac_min != 0 ? load_fac_min : 25);
-    ht_ptr->load_fac_max = (load_fac_max != 0 ? load_fac_max : 75);
-    calculate_rehash_sizes(ht_ptr);
-
-    // Alloc memory
-    ht_ptr->memory_size = ht_ptr->capacity * sizeof(hash_table_uint32_item_t);
-    ht_ptr->memory_ptr = alloc_func(ht_ptr->memory_size);
-    if (ht_ptr->memory_ptr == NULL) {
-        return;
+    ht_ptr->load_fac_min = (config_ptr->load_fac_min != 0 ? config_ptr->load_fac_min : 25);
+    // Two buckets of several slots per key keep the cuckoo mode working at a higher load
+    ht_ptr->load_fac_max = (config_ptr->load_fac_max != 0 ? config_ptr->load_fac_max : (ht_ptr->mode == HTUI32_MODE_CUCKOO ? 90 : 75));
+    ht_ptr->load_fac_hysteresis = (config_ptr->load_fac_hysteresis != 0 ? config_ptr->load_fac_hysteresis : 10);
+    ht_ptr->growth_fac = (config_ptr->growth_fac != 0 ? config_ptr->growth_fac : 200);
+    ht_ptr->auto_shrink = !config_ptr->disable_auto_shrink;
+    ht_ptr->fixed_buffer = false;
+    ht_ptr->fixed_max_size = 0;
+    ht_ptr->reduction = (config_ptr->reduction != HTUI32_REDUCTION_DEFAULT ? config_ptr->reduction : HTUI32_DEFAULT_REDUCTION);
+    capacity = round_capacity(ht_ptr, capacity);
+    ht_ptr->initial_capacity = capacity;
+    if (config_ptr->allocator != NULL) {
+        ht_ptr->allocator = *config_ptr->allocator;
+    }
+    else {
+        ht_ptr->allocator = htui32_default_allocator;
     }
-    memset(ht_ptr->memory_ptr, 0, ht_ptr->memory_size);
 
     ht_ptr->zero_key_is_used = false;
     ht_ptr->zero_key_value = 0;
+
+    ht_ptr->capacity = 0;
+    ht_ptr->memory_ptr = NULL;
+    ht_ptr->slots_ptr = NULL;
+    ht_ptr->ctrl_ptr = NULL;
+    ht_ptr->memory_size = 0;
+    ht_ptr->deleted_count = 0;
+    ht_ptr->snapshot_ptr = NULL;
+    ht_ptr->snapshot_size = 0;
+    ht_ptr->pilots_ptr = NULL;
+    ht_ptr->pilots_count = 0;
+    ht_ptr->dense_pilots_count = 0;
+    ht_ptr->frozen_seed = 0;
+    ht_ptr->overflow_ptr = NULL;
+    ht_ptr->overflow_capacity = 0;
+    ht_ptr->overflow_used = 0;
+    ht_ptr->overflow_free = 0;
+    ht_ptr->cuckoo_memory_ptr = NULL;
+    ht_ptr->incremental_rehash = config_ptr->incremental_rehash;
+    ht_ptr->old_memory_ptr = NULL;
+    ht_ptr->old_capacity = 0;
+    ht_ptr->rehash_pos = 0;
+    ht_ptr->cleared_count = 0;
+    ht_ptr->rehash_step = HTUI32_INCREMENTAL_REHASH_STEP;
+    htui32_pool_init(&ht_ptr->item_pool);
+    memset(&ht_ptr->counters, 0, sizeof(ht_ptr->counters));
+    return true;
 }
 
-void htui32_put(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t value)
+void htui32_init_ex(hash_table_uint32_t* ht_ptr, const htui32_config_t* config_ptr)
 {
-    if (ht_ptr == NULL || ht_ptr->capacity == 0) {
+    htui32_config_t default_config;
+    memset(&default_config, 0, sizeof(default_config));
+    if (config_ptr == NULL) {
+        config_ptr = &default_config;
+    }
+    if (!init_fields(ht_ptr, config_ptr)) {
         return;
     }
+    // Alloc memory, rehashing of the empty table does it
+    // The table stays unusable (capacity is 0) if the memory could not be allocated, put does nothing in this case
+    rehash(ht_ptr, ht_ptr->initial_capacity);
+    calculate_rehash_sizes(ht_ptr);
+}
+
+// Only the open addressing modes keep all keys in their slots, so that the slots can be the caller's buffer
+static bool mode_can_be_fixed(htui32_mode_t mode)
+{
+    return mode == HTUI32_MODE_LINEAR_PROBING || mode == HTUI32_MODE_ROBIN_HOOD || mode == HTUI32_MODE_SWISS;
+}
+
+// Number of slots of the table with the fixed_max_size keys, the load stays below load_fac_max as after htui32_reserve
+static size_t fixed_capacity(hash_table_uint32_t* ht_ptr, size_t max_size)
+{
+    return round_capacity(ht_ptr, max_size * 100 / ht_ptr->load_fac_max + 1);
+}
+
+// Size of the slots (and the control bytes of the Swiss table mode) of capacity slots in bytes
+static size_t fixed_memory_size(hash_table_uint32_t* ht_ptr, size_t capacity)
+{
+    return capacity * (sizeof(hash_table_uint32_slot_t) + (ht_ptr->mode == HTUI32_MODE_SWISS ? 1 : 0));
+}
+
+size_t htui32_fixed_buffer_size(const htui32_config_t* config_ptr)
+{
+    hash_table_uint32_t ht;
+    if (config_ptr == NULL || config_ptr->capacity == 0 || config_ptr->capacity > SIZE_MAX / 200 || !init_fields(&ht, config_ptr)
+        || !mode_can_be_fixed(ht.mode)) {
+        return 0;
+    }
+    return fixed_memory_size(&ht, fixed_capacity(&ht, config_ptr->capacity));
+}
+
+bool htui32_init_fixed(hash_table_uint32_t* ht_ptr, const htui32_config_t* config_ptr, void* buffer, size_t buffer_size)
+{
+    size_t memory_size = htui32_fixed_buffer_size(config_ptr);
+    if (ht_ptr == NULL) {
+        return false;
+    }
+    // The table is unusable until the buffer is attached
+    ht_ptr->capacity = 0;
+    if (memory_size == 0 || buffer == NULL || buffer_size < memory_size || (uintptr_t)buffer % sizeof(uint32_t) != 0) {
+        return false;
+    }
+    init_fields(ht_ptr, config_ptr);
+    size_t capacity = fixed_capacity(ht_ptr, config_ptr->capacity);
+    ht_ptr->fixed_buffer = true;
+    ht_ptr->fixed_max_size = config_ptr->capacity;
+    ht_ptr->auto_shrink = false;
+    ht_ptr->initial_capacity = capacity;
+    if (ht_ptr->mode == HTUI32_MODE_SWISS) {
+        htui32_swiss_attach(ht_ptr, buffer, capacity);
+    }
+    else {
+        ht_ptr->slots_ptr = buffer;
+        ht_ptr->capacity = capacity;
+        ht_ptr->memory_size = memory_size;
+        memset(ht_ptr->slots_ptr, 0, memory_size);
+    }
+    calculate_rehash_sizes(ht_ptr);
+    return true;
+}
+
+// A new key does not fit into the fixed-capacity table
+static inline bool is_full(hash_table_uint32_t* ht_ptr)
+{
+    return ht_ptr->fixed_buffer && ht_ptr->size >= ht_ptr->fixed_max_size;
+}
+
+/*
+ * Returns a pointer to the value of the key in the usable table (capacity is not 0), a missing key is put with value first
+ * and is_inserted_ptr is set to true then. The key is hashed once and usually found or placed with one traversal,
+ * only a key that would grow the table is looked up before the growth and placed after it.
+ * hash is htui32_hash(key), the key is hashed by the caller so that batch operations can prefetch by it
+ * Returns NULL if the key is missing and could not be put
+ */
+static uint32_t* find_or_insert_hashed(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, bool* is_inserted_ptr)
+{
+    incremental_rehash_step(ht_ptr);
+    *is_inserted_ptr = false;
 
     if (key == 0) {
-        if (ht_ptr->zero_key_is_used) {
-            ht_ptr->zero_key_value = value;
-            return;
-        }
-        else {
+        if (!ht_ptr->zero_key_is_used) {
+            if (is_full(ht_ptr)) {
+                return NULL;
+            }
             check_and_grow_rehash(ht_ptr);
             ht_ptr->zero_key_is_used = true;
             ht_ptr->zero_key_value = value;
             ht_ptr->size++;
+            *is_inserted_ptr = true;
         }
+        return &ht_ptr->zero_key_value;
     }
-    else {
-        // Try to find key in hash table
-        hash_table_uint32_item_t* item = NULL;
-        if (find_item_by_key(ht_ptr, key, &item, NULL, NULL)) {
-            // Key is in hash table
-            // Write value
-            item->value = value;
-            return;
-        }
-        else {
-            // Key not in hash table and we need to add new item
-            // Rehash?
-            check_and_grow_rehash(ht_ptr);
-            ht_ptr->size++;
-            // Put new item
-            uint32_t hash = 0;
-            MurmurHash3_x86_32(&key, sizeof(key), 0, &hash);
-            uint32_t pos = hash % ht_ptr->capacity;
-            //printf("Put %u in pos %u\n", key, pos);
-            // Is this position is free?
-            if (ht_ptr->memory_ptr[pos].key == 0) {
-                // Just put the key and value
-                ht_ptr->memory_ptr[pos].key = key;
-                ht_ptr->memory_ptr[pos].value = value;
-            }
-            else {
-                // The position is used, which means we have to add a new item to collision chain
-                // Find last item in collision chain
-                hash_table_uint32_item_t* last_item = &ht_ptr->memory_ptr[pos];
-                while (last_item->next != NULL) {
-                    last_item = last_item->next;
-                }
-                // Add new item to collision chain
-                hash_table_uint32_item_t* new_item = alloc_func(sizeof(hash_table_uint32_item_t));
-                if (new_item == NULL) {
-                    return;
-                }
-                new_item->key = key;
-                new_item->value = value;
-                new_item->next = NULL;
-                last_item->next = new_item;
-            }
+    // The table grows only for a new key, so the key is looked up first when a new one would grow the table or not fit at all
+    if (is_full(ht_ptr) || (ht_ptr->size + 1 >= ht_ptr->rehash_max_size && !ht_ptr->fixed_buffer)) {
+        uint32_t* value_ptr = find_value(ht_ptr, key, hash);
+        if (value_ptr != NULL || is_full(ht_ptr)) {
+            return value_ptr;
         }
+        check_and_grow_rehash(ht_ptr);
     }
+    uint32_t* value_ptr = find_or_insert_item(ht_ptr, key, hash, value, is_inserted_ptr);
+    if (*is_inserted_ptr) {
+        ht_ptr->size++;
+    }
+    return value_ptr;
 }
 
-bool htui32_get(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t* value_ptr)
+/*
+ * Puts value by key in the usable table (capacity is not 0), hash is htui32_hash(key)
+ * Returns false if the key is new and could not be put
+ */
+static bool put_hashed(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value)
 {
-    if (ht_ptr == NULL || ht_ptr->size == 0) {
+    bool is_inserted = false;
+    uint32_t* value_ptr = find_or_insert_hashed(ht_ptr, key, hash, value, &is_inserted);
+    if (value_ptr == NULL) {
         return false;
     }
+    *value_ptr = value;
+    return true;
+}
 
+// Gets value by key from the non-empty table, hash is htui32_hash(key)
+static bool get_hashed(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t* value_ptr)
+{
     if (key == 0) {
         if (ht_ptr->zero_key_is_used) {
             if (value_ptr != NULL) {
@@ -258,11 +781,11 @@ bool htui32_get(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t* value_ptr)
         }
     }
     else {
-        hash_table_uint32_item_t* item = NULL;
         // Key in hash table?
-        if (find_item_by_key(ht_ptr, key, &item, NULL, NULL) == true) {
+        uint32_t* item_value_ptr = find_value(ht_ptr, key, hash);
+        if (item_value_ptr != NULL) {
             if (value_ptr != NULL) {
-                *value_ptr = item->value;
+                *value_ptr = *item_value_ptr;
             }
             return true;
         }
@@ -272,39 +795,24 @@ bool htui32_get(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t* value_ptr)
     }
 }
 
-void htui32_delete(hash_table_uint32_t* ht_ptr, uint32_t key)
+// Deletes value by key from the non-empty table, hash is htui32_hash(key)
+static void delete_hashed(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
 {
-    if (ht_ptr == NULL || ht_ptr->size == 0) {
-        return;
-    }
+    incremental_rehash_step(ht_ptr);
 
     if (key == 0) {
         if (ht_ptr->zero_key_is_used) {
             ht_ptr->zero_key_is_used = false;
             ht_ptr->zero_key_value = 0;
             ht_ptr->size--;
-            check_and_shrink_rehash(ht_ptr);
         }
         else {
             return;
         }
     }
     else {
-        // Try to find key in hash table
-        hash_table_uint32_item_t* item = NULL;
-        hash_table_uint32_item_t* prev_item = NULL;
-        hash_table_uint32_item_t* next_item = NULL;
-        if (find_item_by_key(ht_ptr, key, &item, &prev_item, &next_item)) {
-            // Is first in collision chain?
-            if (prev_item == NULL) {
-                // Clear key and value
-                item->key = 0;
-                item->value = 0;
-            }
-            else {
-                prev_item->next = next_item;
-                free_func(item);
-            }
+        // Try to remove key from hash table
+        if (remove_item(ht_ptr, key, hash)) {
             ht_ptr->size--;
         }
         else {
@@ -316,46 +824,626 @@ void htui32_delete(hash_table_uint32_t* ht_ptr, uint32_t key)
     check_and_shrink_rehash(ht_ptr);
 }
 
+bool htui32_put_hashed(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value)
+{
+    if (!is_writable(ht_ptr)) {
+        return false;
+    }
+    return put_hashed(ht_ptr, key, hash, value);
+}
+
+bool htui32_get_hashed(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t* value_ptr)
+{
+    if (ht_ptr == NULL || ht_ptr->size == 0) {
+        return false;
+    }
+    return get_hashed(ht_ptr, key, hash, value_ptr);
+}
+
+void htui32_delete_hashed(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    if (!is_writable(ht_ptr) || ht_ptr->size == 0) {
+        return;
+    }
+    delete_hashed(ht_ptr, key, hash);
+}
+
+bool htui32_put(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t value)
+{
+    if (!is_writable(ht_ptr)) {
+        return false;
+    }
+    return put_hashed(ht_ptr, key, htui32_hash(key), value);
+}
+
+bool htui32_get(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t* value_ptr)
+{
+    if (ht_ptr == NULL || ht_ptr->size == 0) {
+        return false;
+    }
+    return get_hashed(ht_ptr, key, htui32_hash(key), value_ptr);
+}
+
+void htui32_delete(hash_table_uint32_t* ht_ptr, uint32_t key)
+{
+    if (!is_writable(ht_ptr) || ht_ptr->size == 0) {
+        return;
+    }
+    delete_hashed(ht_ptr, key, htui32_hash(key));
+}
+
+uint32_t* htui32_get_or_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t value)
+{
+    if (!is_writable(ht_ptr)) {
+        return NULL;
+    }
+    bool is_inserted = false;
+    return find_or_insert_hashed(ht_ptr, key, htui32_hash(key), value, &is_inserted);
+}
+
+bool htui32_insert_if_absent(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t value)
+{
+    if (!is_writable(ht_ptr)) {
+        return false;
+    }
+    bool is_inserted = false;
+    find_or_insert_hashed(ht_ptr, key, htui32_hash(key), value, &is_inserted);
+    return is_inserted;
+}
+
+bool htui32_fetch_add(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t delta, uint32_t* old_value_ptr)
+{
+    if (!is_writable(ht_ptr)) {
+        return false;
+    }
+    // A missing key starts from 0, so it is put with delta at once
+    bool is_inserted = false;
+    uint32_t* value_ptr = find_or_insert_hashed(ht_ptr, key, htui32_hash(key), delta, &is_inserted);
+    if (value_ptr == NULL) {
+        return false;
+    }
+    uint32_t old_value = is_inserted ? 0 : *value_ptr;
+    if (!is_inserted) {
+        *value_ptr = old_value + delta;
+    }
+    if (old_value_ptr != NULL) {
+        *old_value_ptr = old_value;
+    }
+    return true;
+}
+
+bool htui32_compare_and_set(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t expected_value, uint32_t new_value)
+{
+    if (!is_writable(ht_ptr) || ht_ptr->size == 0) {
+        return false;
+    }
+    uint32_t* value_ptr = NULL;
+    if (key == 0) {
+        value_ptr = ht_ptr->zero_key_is_used ? &ht_ptr->zero_key_value : NULL;
+    }
+    else {
+        value_ptr = find_value(ht_ptr, key, htui32_hash(key));
+    }
+    if (value_ptr == NULL || *value_ptr != expected_value) {
+        return false;
+    }
+    *value_ptr = new_value;
+    return true;
+}
+
+/*
+ * Batch operations hash up to HTUI32_BATCH_PREFETCH_COUNT keys and prefetch the memory of all of them first,
+ * and only then resolve the keys one by one, so the cache misses of different keys overlap.
+ * A rehash in the middle of a chunk only makes the rest of its prefetches useless.
+ */
+
+void htui32_get_batch(hash_table_uint32_t* ht_ptr, const uint32_t* keys, uint32_t* values, bool* found, size_t count)
+{
+    if (ht_ptr == NULL || keys == NULL) {
+        return;
+    }
+    uint32_t hashes[HTUI32_BATCH_PREFETCH_COUNT];
+    for (size_t begin = 0; begin < count; begin += HTUI32_BATCH_PREFETCH_COUNT) {
+        size_t chunk_count = (count - begin < HTUI32_BATCH_PREFETCH_COUNT) ? count - begin : HTUI32_BATCH_PREFETCH_COUNT;
+        if (ht_ptr->size != 0) {
+            for (size_t i = 0; i < chunk_count; ++i) {
+                hashes[i] = htui32_hash(keys[begin + i]);
+                prefetch_item(ht_ptr, hashes[i]);
+            }
+        }
+        for (size_t i = 0; i < chunk_count; ++i) {
+            bool has_found = false;
+            if (ht_ptr->size != 0) {
+                has_found = get_hashed(ht_ptr, keys[begin + i], hashes[i], values != NULL ? &values[begin + i] : NULL);
+            }
+            if (found != NULL) {
+                found[begin + i] = has_found;
+            }
+        }
+    }
+}
+
+bool htui32_put_batch(hash_table_uint32_t* ht_ptr, const uint32_t* keys, const uint32_t* values, size_t count)
+{
+    if (!is_writable(ht_ptr) || keys == NULL || values == NULL) {
+        return false;
+    }
+    bool are_put = true;
+    uint32_t hashes[HTUI32_BATCH_PREFETCH_COUNT];
+    for (size_t begin = 0; begin < count; begin += HTUI32_BATCH_PREFETCH_COUNT) {
+        size_t chunk_count = (count - begin < HTUI32_BATCH_PREFETCH_COUNT) ? count - begin : HTUI32_BATCH_PREFETCH_COUNT;
+        for (size_t i = 0; i < chunk_count; ++i) {
+            hashes[i] = htui32_hash(keys[begin + i]);
+            prefetch_item(ht_ptr, hashes[i]);
+        }
+        for (size_t i = 0; i < chunk_count; ++i) {
+            if (!put_hashed(ht_ptr, keys[begin + i], hashes[i], values[begin + i])) {
+                are_put = false;
+            }
+        }
+    }
+    return are_put;
+}
+
+void htui32_delete_batch(hash_table_uint32_t* ht_ptr, const uint32_t* keys, size_t count)
+{
+    if (!is_writable(ht_ptr) || keys == NULL) {
+        return;
+    }
+    uint32_t hashes[HTUI32_BATCH_PREFETCH_COUNT];
+    for (size_t begin = 0; begin < count && ht_ptr->size != 0; begin += HTUI32_BATCH_PREFETCH_COUNT) {
+        size_t chunk_count = (count - begin < HTUI32_BATCH_PREFETCH_COUNT) ? count - begin : HTUI32_BATCH_PREFETCH_COUNT;
+        for (size_t i = 0; i < chunk_count; ++i) {
+            hashes[i] = htui32_hash(keys[begin + i]);
+            prefetch_item(ht_ptr, hashes[i]);
+        }
+        for (size_t i = 0; i < chunk_count && ht_ptr->size != 0; ++i) {
+            delete_hashed(ht_ptr, keys[begin + i], hashes[i]);
+        }
+    }
+}
+
+bool htui32_reserve(hash_table_uint32_t* ht_ptr, size_t count)
+{
+    if (!is_writable(ht_ptr)) {
+        return false;
+    }
+    if (ht_ptr->fixed_buffer) {
+        return count <= ht_ptr->fixed_max_size;
+    }
+    // A put grows the table when the size reaches rehash_max_size,
+    // so count keys fit if capacity * load_fac_max / 100 > count
+    size_t new_capacity = round_capacity(ht_ptr, count * 100 / ht_ptr->load_fac_max + 1);
+    if (new_capacity <= ht_ptr->capacity) {
+        return true;
+    }
+    uint64_t start_ns = htui32_stats_now_ns();
+    bool is_rehashed = rehash(ht_ptr, new_capacity);
+    HTUI32_COUNT(ht_ptr, rehash_time_ns, htui32_stats_now_ns() - start_ns);
+    if (!is_rehashed) {
+        return false;
+    }
+    HTUI32_COUNT(ht_ptr, grow_count, 1);
+    calculate_rehash_sizes(ht_ptr);
+    return true;
+}
+
+bool htui32_compact(hash_table_uint32_t* ht_ptr)
+{
+    if (!is_writable(ht_ptr)) {
+        return false;
+    }
+    // The smallest capacity at which the keys stay load_fac_hysteresis below load_fac_max, like after shrinking
+    size_t load_fac = (ht_ptr->load_fac_max > ht_ptr->load_fac_hysteresis) ? ht_ptr->load_fac_max - ht_ptr->load_fac_hysteresis : ht_ptr->load_fac_max;
+    size_t new_capacity = round_capacity(ht_ptr, ht_ptr->size * 100 / load_fac + 1);
+    if (new_capacity < ht_ptr->initial_capacity) {
+        new_capacity = ht_ptr->initial_capacity;
+    }
+    uint64_t start_ns = htui32_stats_now_ns();
+    bool is_rehashed = true;
+    if (new_capacity < ht_ptr->capacity && !ht_ptr->fixed_buffer) {
+        is_rehashed = rehash(ht_ptr, new_capacity);
+        if (is_rehashed) {
+            HTUI32_COUNT(ht_ptr, shrink_count, 1);
+        }
+    }
+    else if (ht_ptr->mode == HTUI32_MODE_SWISS && ht_ptr->deleted_count != 0) {
+        // Rehashing to the same capacity gets rid of the DELETED slots
+        is_rehashed = htui32_swiss_rehash(ht_ptr, ht_ptr->capacity);
+    }
+    // Incremental rehashing, including the one just started, is completed at once
+    if (!chaining_rehash_step(ht_ptr, SIZE_MAX)) {
+        is_rehashed = false;
+    }
+    HTUI32_COUNT(ht_ptr, rehash_time_ns, htui32_stats_now_ns() - start_ns);
+    calculate_rehash_sizes(ht_ptr);
+    return is_rehashed;
+}
+
+bool htui32_build(hash_table_uint32_t* ht_ptr, const uint32_t* keys, const uint32_t* values, size_t count)
+{
+    if (!is_writable(ht_ptr) || keys == NULL || values == NULL) {
+        return false;
+    }
+    if (!htui32_reserve(ht_ptr, ht_ptr->size + count)) {
+        return false;
+    }
+    // The table is large enough, so the keys are put without any growth checks and, being unique, without lookups
+    uint32_t hashes[HTUI32_BATCH_PREFETCH_COUNT];
+    for (size_t begin = 0; begin < count; begin += HTUI32_BATCH_PREFETCH_COUNT) {
+        size_t chunk_count = (count - begin < HTUI32_BATCH_PREFETCH_COUNT) ? count - begin : HTUI32_BATCH_PREFETCH_COUNT;
+        for (size_t i = 0; i < chunk_count; ++i) {
+            hashes[i] = htui32_hash(keys[begin + i]);
+            prefetch_item(ht_ptr, hashes[i]);
+        }
+        for (size_t i = 0; i < chunk_count; ++i) {
+            uint32_t key = keys[begin + i];
+            if (key == 0) {
+                ht_ptr->zero_key_is_used = true;
+                ht_ptr->zero_key_value = values[begin + i];
+                ht_ptr->size++;
+            }
+            else if (insert_unique_item(ht_ptr, key, hashes[i], values[begin + i])) {
+                ht_ptr->size++;
+            }
+            else {
+                return false;
+            }
+        }
+        incremental_rehash_step(ht_ptr);
+    }
+    return true;
+}
+
 void htui32_destroy(hash_table_uint32_t* ht_ptr)
 {
     if (ht_ptr == NULL) {
         return;
     }
-    // Free second collision chain items
-    for (size_t i = 0; i < ht_ptr->capacity; ++i) {
-        hash_table_uint32_item_t* current_item = ht_ptr->memory_ptr[i].next;
-        while (current_item != NULL) {
-            hash_table_uint32_item_t* next_item = current_item->next;
-            free_func(current_item);
-            current_item = next_item;
+    if (ht_ptr->mode == HTUI32_MODE_SNAPSHOT) {
+        htui32_snapshot_unmap(ht_ptr);
+        return;
+    }
+    // The caller's buffer stays with the caller
+    if (ht_ptr->fixed_buffer) {
+        return;
+    }
+    if (ht_ptr->mode == HTUI32_MODE_COMPACT_CHAINING) {
+        htui32_compact_chaining_free(ht_ptr);
+        return;
+    }
+    if (ht_ptr->mode == HTUI32_MODE_CUCKOO) {
+        htui32_cuckoo_free(ht_ptr);
+        return;
+    }
+    if (ht_ptr->mode != HTUI32_MODE_CHAINING) {
+        if (ht_ptr->slots_ptr != NULL) {
+            free_func(ht_ptr, ht_ptr->slots_ptr, ht_ptr->memory_size);
         }
+        return;
+    }
+    // Free collision chain items
+    htui32_pool_free(&ht_ptr->item_pool, &ht_ptr->allocator);
+    // Free old memory of incremental rehashing
+    if (ht_ptr->old_memory_ptr != NULL) {
+        free_func(ht_ptr, ht_ptr->old_memory_ptr, ht_ptr->old_capacity * sizeof(hash_table_uint32_item_t));
+    }
+    if (ht_ptr->memory_ptr == NULL) {
+        return;
     }
     // Free main(first) items
-    if (ht_ptr->memory_ptr != NULL) {
-        free_func(ht_ptr->memory_ptr);
+    free_func(ht_ptr, ht_ptr->memory_ptr, ht_ptr->memory_size);
+}
+
+// Visits the collision chains of the buckets
+static void visit_buckets(hash_table_uint32_item_t* memory, size_t capacity, htui32_item_visitor_t visitor, void* context)
+{
+    for (size_t i = 0; i < capacity; ++i) {
+        for (hash_table_uint32_item_t* current_item = &memory[i]; current_item != NULL; current_item = current_item->next) {
+            if (current_item->key != 0) {
+                visitor(context, current_item->key, current_item->value);
+            }
+        }
     }
 }
 
-void htui32_print_iternal_rep(hash_table_uint32_t* ht_ptr)
+void htui32_visit_items(hash_table_uint32_t* ht_ptr, htui32_item_visitor_t visitor, void* context)
 {
+    switch (ht_ptr->mode) {
+    case HTUI32_MODE_CHAINING:
+        if (ht_ptr->old_memory_ptr != NULL) {
+            visit_buckets(ht_ptr->old_memory_ptr, ht_ptr->old_capacity, visitor, context);
+        }
+        visit_buckets(ht_ptr->memory_ptr, ht_ptr->cleared_count, visitor, context);
+        break;
+    case HTUI32_MODE_SNAPSHOT: {
+        const htui32_snapshot_entry_t* entries = htui32_snapshot_entries(ht_ptr);
+        for (size_t i = 0; i < htui32_snapshot_entries_count(ht_ptr); ++i) {
+            if (entries[i].key != 0) {
+                visitor(context, entries[i].key, entries[i].value);
+            }
+        }
+        break;
+    }
+    case HTUI32_MODE_COMPACT_CHAINING:
+        htui32_compact_chaining_visit(ht_ptr, visitor, context);
+        break;
+    default:
+        for (size_t i = 0; i < ht_ptr->capacity; ++i) {
+            // A deleted Swiss table slot keeps its key
+            bool is_used = (ht_ptr->mode == HTUI32_MODE_SWISS) ? htui32_swiss_slot_is_used(ht_ptr, i) : ht_ptr->slots_ptr[i].key != 0;
+            if (is_used) {
+                visitor(context, ht_ptr->slots_ptr[i].key, ht_ptr->slots_ptr[i].value);
+            }
+        }
+        break;
+    }
+}
+
+/*
+ * Reads the key with index chain_index of the collision chain of the bucket at pos (0 is the bucket itself),
+ * pos counts the buckets of the old memory of incremental rehashing first, key_ptr gets 0 for an empty bucket (slot)
+ * Returns false if the bucket has no key with this index
+ */
+static bool iter_read(const htui32_iter_t* iter_ptr, size_t pos, size_t chain_index, uint32_t* key_ptr, uint32_t* value_ptr)
+{
+    hash_table_uint32_t* ht_ptr = iter_ptr->ht_ptr;
+    switch (ht_ptr->mode) {
+    case HTUI32_MODE_CHAINING: {
+        // The buckets that are not cleared yet have no keys
+        if (pos >= ht_ptr->old_capacity + ht_ptr->cleared_count) {
+            return false;
+        }
+        hash_table_uint32_item_t* item = (pos < ht_ptr->old_capacity) ? &ht_ptr->old_memory_ptr[pos] : &ht_ptr->memory_ptr[pos - ht_ptr->old_capacity];
+        for (; chain_index != 0 && item != NULL; --chain_index) {
+            item = item->next;
+        }
+        if (item == NULL) {
+            return false;
+        }
+        *key_ptr = item->key;
+        *value_ptr = item->value;
+        return true;
+    }
+    case HTUI32_MODE_SNAPSHOT: {
+        const htui32_snapshot_entry_t* entry = &htui32_snapshot_entries(ht_ptr)[pos];
+        *key_ptr = entry->key;
+        *value_ptr = entry->value;
+        return chain_index == 0;
+    }
+    case HTUI32_MODE_COMPACT_CHAINING:
+        return htui32_compact_chaining_read(ht_ptr, pos, chain_index, key_ptr, value_ptr);
+    default: {
+        size_t slot = iter_ptr->start_slot + pos;
+        if (slot >= ht_ptr->capacity) {
+            slot -= ht_ptr->capacity;
+        }
+        // A deleted Swiss table slot keeps its key
+        bool is_used = (ht_ptr->mode == HTUI32_MODE_SWISS) ? htui32_swiss_slot_is_used(ht_ptr, slot) : ht_ptr->slots_ptr[slot].key != 0;
+        *key_ptr = is_used ? ht_ptr->slots_ptr[slot].key : 0;
+        *value_ptr = ht_ptr->slots_ptr[slot].value;
+        return chain_index == 0;
+    }
+    }
+}
+
+void htui32_iter_init(htui32_iter_t* iter_ptr, hash_table_uint32_t* ht_ptr)
+{
+    iter_ptr->ht_ptr = ht_ptr;
+    iter_ptr->pos = 0;
+    iter_ptr->chain_index = 0;
+    iter_ptr->current_pos = 0;
+    iter_ptr->current_chain_index = 0;
+    iter_ptr->current_key = 0;
+    iter_ptr->has_current = false;
+    iter_ptr->start_slot = 0;
+    // At least one slot of the open addressing modes is always free
+    if (ht_ptr != NULL && (ht_ptr->mode == HTUI32_MODE_LINEAR_PROBING || ht_ptr->mode == HTUI32_MODE_ROBIN_HOOD)) {
+        while (iter_ptr->start_slot < ht_ptr->capacity && ht_ptr->slots_ptr[iter_ptr->start_slot].key != 0) {
+            iter_ptr->start_slot++;
+        }
+        if (iter_ptr->start_slot == ht_ptr->capacity) {
+            iter_ptr->start_slot = 0;
+        }
+    }
+}
+
+bool htui32_iter_next(htui32_iter_t* iter_ptr, uint32_t* key_ptr, uint32_t* value_ptr)
+{
+    hash_table_uint32_t* ht_ptr = iter_ptr->ht_ptr;
+    iter_ptr->has_current = false;
     if (ht_ptr == NULL) {
-        return;
+        return false;
+    }
+    uint32_t key = 0;
+    uint32_t value = 0;
+    bool has_found = false;
+    if (iter_ptr->pos == 0) {
+        iter_ptr->pos = 1;
+        iter_ptr->chain_index = 0;
+        if (ht_ptr->zero_key_is_used) {
+            iter_ptr->current_pos = 0;
+            iter_ptr->current_chain_index = 0;
+            value = ht_ptr->zero_key_value;
+            has_found = true;
+        }
+    }
+    size_t positions_count = 1 + ht_ptr->old_capacity + (ht_ptr->mode == HTUI32_MODE_SNAPSHOT ? htui32_snapshot_entries_count(ht_ptr) : ht_ptr->capacity);
+    while (!has_found && iter_ptr->pos < positions_count) {
+        if (!iter_read(iter_ptr, iter_ptr->pos - 1, iter_ptr->chain_index, &key, &value)) {
+            iter_ptr->pos++;
+            iter_ptr->chain_index = 0;
+            continue;
+        }
+        iter_ptr->chain_index++;
+        // The first item of a chaining mode bucket is empty after its key is deleted, the chain goes on
+        if (key != 0) {
+            iter_ptr->current_pos = iter_ptr->pos;
+            iter_ptr->current_chain_index = iter_ptr->chain_index - 1;
+            has_found = true;
+        }
+    }
+    if (!has_found) {
+        return false;
+    }
+    iter_ptr->current_key = key;
+    iter_ptr->has_current = true;
+    *key_ptr = key;
+    if (value_ptr != NULL) {
+        *value_ptr = value;
     }
+    return true;
+}
 
-    printf("%u %u\n", ht_ptr->size, ht_ptr->capacity);
+bool htui32_iter_delete(htui32_iter_t* iter_ptr)
+{
+    hash_table_uint32_t* ht_ptr = iter_ptr->ht_ptr;
+    if (!iter_ptr->has_current || !is_writable(ht_ptr)) {
+        return false;
+    }
+    iter_ptr->has_current = false;
+    // Unlike delete_hashed, no incremental rehashing step and no shrinking, they would move the keys under the cursor
+    if (iter_ptr->current_key == 0) {
+        ht_ptr->zero_key_is_used = false;
+        ht_ptr->zero_key_value = 0;
+    }
+    else if (!remove_item(ht_ptr, iter_ptr->current_key, htui32_hash(iter_ptr->current_key))) {
+        return false;
+    }
+    ht_ptr->size--;
+    // Deletes keep the order of a chain and backward shifting moves the following keys of a cluster towards the free slot,
+    // so the next key may take the position of the deleted one now
+    iter_ptr->pos = iter_ptr->current_pos;
+    iter_ptr->chain_index = iter_ptr->current_chain_index;
+    return true;
+}
 
+void htui32_foreach(hash_table_uint32_t* ht_ptr, htui32_foreach_func_t func, void* context)
+{
+    if (ht_ptr == NULL) {
+        return;
+    }
     if (ht_ptr->zero_key_is_used) {
-        printf("(0:%u)\n", ht_ptr->zero_key_value);
+        func(context, 0, ht_ptr->zero_key_value);
     }
+    htui32_visit_items(ht_ptr, func, context);
+}
 
-    for (size_t i = 0; i < ht_ptr->capacity; ++i) {
-        hash_table_uint32_item_t* current_item = &ht_ptr->memory_ptr[i];
+size_t htui32_export(hash_table_uint32_t* ht_ptr, uint32_t* keys, uint32_t* values, size_t max_count)
+{
+    htui32_iter_t iter;
+    htui32_iter_init(&iter, ht_ptr);
+    size_t count = 0;
+    while (count < max_count && htui32_iter_next(&iter, &keys[count], values != NULL ? &values[count] : NULL)) {
+        count++;
+    }
+    return count;
+}
+
+// Adds a chain of length to the statistics
+static void stats_add_chain(htui32_stats_t* stats_ptr, size_t length)
+{
+    stats_ptr->chain_length_histogram[length < HTUI32_STATS_HISTOGRAM_SIZE ? length : HTUI32_STATS_HISTOGRAM_SIZE - 1]++;
+    if (length == 0) {
+        return;
+    }
+    stats_ptr->used_buckets++;
+    if (length > stats_ptr->max_chain_length) {
+        stats_ptr->max_chain_length = length;
+    }
+}
+
+// Adds the collision chains of the buckets to the statistics, returns the total length of the chains
+static size_t stats_add_buckets(htui32_stats_t* stats_ptr, hash_table_uint32_item_t* memory, size_t capacity)
+{
+    size_t total_length = 0;
+    for (size_t i = 0; i < capacity; ++i) {
+        // The first item of a chain can be empty after a delete while the next items are still used
+        size_t length = (memory[i].key != 0) ? 1 : 0;
+        for (hash_table_uint32_item_t* current_item = memory[i].next; current_item != NULL; current_item = current_item->next) {
+            length++;
+            stats_ptr->overflow_items++;
+        }
+        stats_add_chain(stats_ptr, length);
+        total_length += length;
+    }
+    return total_length;
+}
+
+void htui32_stats(hash_table_uint32_t* ht_ptr, htui32_stats_t* stats_ptr)
+{
+    if (ht_ptr == NULL || stats_ptr == NULL) {
+        return;
+    }
+    memset(stats_ptr, 0, sizeof(*stats_ptr));
+    stats_ptr->size = ht_ptr->size;
+    stats_ptr->capacity = ht_ptr->capacity;
+    stats_ptr->counters_enabled = HTUI32_STATS;
+    stats_ptr->counters = ht_ptr->counters;
+    stats_ptr->memory_bytes = ht_ptr->memory_size;
+
+    size_t total_length = 0;
+    if (ht_ptr->mode == HTUI32_MODE_CHAINING) {
+        if (ht_ptr->old_memory_ptr != NULL) {
+            total_length += stats_add_buckets(stats_ptr, ht_ptr->old_memory_ptr, ht_ptr->old_capacity);
+            stats_ptr->memory_bytes += ht_ptr->old_capacity * sizeof(hash_table_uint32_item_t);
+        }
+        total_length += stats_add_buckets(stats_ptr, ht_ptr->memory_ptr, ht_ptr->cleared_count);
+        // The buckets that are not cleared yet are empty
+        stats_ptr->chain_length_histogram[0] += ht_ptr->capacity - ht_ptr->cleared_count;
+        stats_ptr->memory_bytes += htui32_pool_memory_size(&ht_ptr->item_pool);
+    }
+    else if (ht_ptr->mode == HTUI32_MODE_SNAPSHOT || ht_ptr->mode == HTUI32_MODE_COMPACT_CHAINING) {
+        if (ht_ptr->mode == HTUI32_MODE_SNAPSHOT) {
+            stats_ptr->memory_bytes = ht_ptr->snapshot_size;
+        }
+        for (size_t i = 0; i < ht_ptr->capacity; ++i) {
+            size_t length = (ht_ptr->mode == HTUI32_MODE_SNAPSHOT) ? htui32_snapshot_chain_length(ht_ptr, i) : htui32_compact_chaining_length(ht_ptr, i);
+            stats_ptr->overflow_items += (length != 0) ? length - 1 : 0;
+            stats_add_chain(stats_ptr, length);
+            total_length += length;
+        }
+    }
+    else {
+        // Every used slot is the end of the probe sequence of its key, free slots are chains of length 0
+        for (size_t i = 0; i < ht_ptr->capacity; ++i) {
+            size_t length = 0;
+            if (ht_ptr->mode == HTUI32_MODE_SWISS) {
+                if (htui32_swiss_slot_is_used(ht_ptr, i)) {
+                    length = htui32_swiss_probe_length(ht_ptr, i);
+                }
+            }
+            else if (ht_ptr->mode == HTUI32_MODE_FROZEN) {
+                // Every key is found in its slot at once
+                length = (ht_ptr->slots_ptr[i].key != 0) ? 1 : 0;
+            }
+            else if (ht_ptr->mode == HTUI32_MODE_CUCKOO) {
+                if (ht_ptr->slots_ptr[i].key != 0) {
+                    length = htui32_cuckoo_probe_length(ht_ptr, i);
+                }
+            }
+            else if (ht_ptr->slots_ptr[i].key != 0) {
+                length = htui32_open_probe_length(ht_ptr, i);
+            }
+            stats_add_chain(stats_ptr, length);
+            total_length += length;
+        }
+    }
+    if (stats_ptr->used_buckets != 0) {
+        stats_ptr->mean_chain_length_x100 = total_length * 100 / stats_ptr->used_buckets;
+    }
+}
+
+static void print_buckets(hash_table_uint32_item_t* memory, size_t capacity, const char* prefix)
+{
+    for (size_t i = 0; i < capacity; ++i) {
+        hash_table_uint32_item_t* current_item = &memory[i];
         bool is_first_in_collision_chain = true;
         while (current_item != NULL) {
             if (current_item->key != 0) {
                 if (is_first_in_collision_chain) {
                     is_first_in_collision_chain = false;
-                    printf("[%u]: ", i);
+                    printf("%s[%zu]: ", prefix, i);
                 }
                 printf("(%u:%u) ", current_item->key, current_item->value);
             }
@@ -366,3 +1454,58 @@ void htui32_print_iternal_rep(hash_table_uint32_t* ht_ptr)
         }
     }
 }
+
+void htui32_print_iternal_rep(hash_table_uint32_t* ht_ptr)
+{
+    if (ht_ptr == NULL) {
+        return;
+    }
+
+    printf("%u %u\n", ht_ptr->size, ht_ptr->capacity);
+
+    if (ht_ptr->zero_key_is_used) {
+        printf("(0:%u)\n", ht_ptr->zero_key_value);
+    }
+
+    if (ht_ptr->mode == HTUI32_MODE_SNAPSHOT) {
+        const htui32_snapshot_entry_t* entries = htui32_snapshot_entries(ht_ptr);
+        for (size_t i = 0; i < htui32_snapshot_entries_count(ht_ptr); ++i) {
+            if (entries[i].key != 0) {
+                printf("[%zu]: (%u:%u) -> %u\n", i, entries[i].key, entries[i].value, entries[i].next);
+            }
+        }
+        return;
+    }
+
+    if (ht_ptr->mode == HTUI32_MODE_COMPACT_CHAINING) {
+        for (size_t i = 0; i < ht_ptr->capacity; ++i) {
+            hash_table_uint32_slot_t* bucket = &ht_ptr->slots_ptr[i];
+            if (bucket->key != 0) {
+                printf("[%zu]: (%u:%u)\n", i, bucket->key, bucket->value);
+            }
+            else if (bucket->value != 0) {
+                printf("[%zu]: ", i);
+                for (uint32_t index = bucket->value; index != 0; index = ht_ptr->overflow_ptr[index - 1].next) {
+                    printf("(%u:%u) ", ht_ptr->overflow_ptr[index - 1].key, ht_ptr->overflow_ptr[index - 1].value);
+                }
+                printf("\n");
+            }
+        }
+        return;
+    }
+
+    if (ht_ptr->mode != HTUI32_MODE_CHAINING) {
+        for (size_t i = 0; i < ht_ptr->capacity; ++i) {
+            if (ht_ptr->slots_ptr[i].key != 0) {
+                printf("[%zu]: (%u:%u)\n", i, ht_ptr->slots_ptr[i].key, ht_ptr->slots_ptr[i].value);
+            }
+        }
+        return;
+    }
+
+    // Buckets of the old memory that are not moved yet by incremental rehashing
+    if (ht_ptr->old_memory_ptr != NULL) {
+        print_buckets(ht_ptr->old_memory_ptr, ht_ptr->old_capacity, "old");
+    }
+    print_buckets(ht_ptr->memory_ptr, ht_ptr->cleared_count, "");
+}
\ No newline at end of file
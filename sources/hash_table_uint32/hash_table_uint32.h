@@ -5,12 +5,17 @@
  * Hash table implementation designed for keys and values of uint32_t type.
  * It is oriented to use in my SLAB allocator in TEUOS instead of usual applications.
  * 
- * Hash table with separate chaining.
- * Uses MurmurHash3 as a hash function.
+ * Hash table with separate chaining (default) or open addressing (linear, Robin Hood or Swiss table probing).
+ * Uses the MurmurHash3 finalizer as a hash function (see hash_table_uint32_hash.h).
  */
 
 #include <stdint.h>
 #include <stdbool.h>
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
 
 typedef struct hash_table_uint32_item {
     // Pointer to the next structure in the collision chain, used as sllist_node_t by sllist.h
@@ -19,6 +24,118 @@ typedef struct hash_table_uint32_item {
     uint32_t value;
 } hash_table_uint32_item_t;
 
+// Item of the open addressing modes, stored inline in slots_ptr without any per-item allocation
+typedef struct {
+    uint32_t key;
+    uint32_t value;
+} hash_table_uint32_slot_t;
+
+// Collision chain item of the compact chaining mode, stored in overflow_ptr and linked by index
+typedef struct {
+    uint32_t key;
+    uint32_t value;
+    // Index of the next item of the chain plus 1, 0 at the end of the chain
+    uint32_t next;
+} hash_table_uint32_overflow_item_t;
+
+// Collision resolution strategy of the table
+typedef enum {
+    // Use HTUI32_DEFAULT_MODE
+    HTUI32_MODE_DEFAULT = 0,
+    // Separate chaining, collision items are allocated one by one
+    HTUI32_MODE_CHAINING = 1,
+    // Open addressing with linear probing
+    HTUI32_MODE_LINEAR_PROBING = 2,
+    // Open addressing with Robin Hood probing
+    HTUI32_MODE_ROBIN_HOOD = 3,
+    // Open addressing with control bytes probed by groups using SIMD (capacity is rounded up to a power of two of at least 16 or 32)
+    HTUI32_MODE_SWISS = 4,
+    // Read-only table mapped from a snapshot file by htui32_open_mmap, it cannot be requested in htui32_config_t
+    HTUI32_MODE_SNAPSHOT = 5,
+    // Read-only table on a minimal perfect hash made by htui32_freeze, it cannot be requested in htui32_config_t
+    HTUI32_MODE_FROZEN = 6,
+    // Separate chaining with 8-byte buckets, a bucket holds its only key or the index of its collision chain,
+    // chain items are 12 bytes in one array, so there are no pointers and no per-item allocation
+    HTUI32_MODE_COMPACT_CHAINING = 7,
+    // Bucketized cuckoo hashing, a key is in one of its two buckets of HTUI32_CUCKOO_BUCKET_SLOTS slots,
+    // a lookup reads at most two buckets (cache lines), the table stays without chains above 90% load
+    // (capacity is rounded up to a power of two of at least HTUI32_CUCKOO_BUCKET_SLOTS)
+    HTUI32_MODE_CUCKOO = 8
+} htui32_mode_t;
+
+// Reduction of a key hash to a bucket (slot) position of the table
+typedef enum {
+    // Use HTUI32_DEFAULT_REDUCTION
+    HTUI32_REDUCTION_DEFAULT = 0,
+    // hash % capacity, any capacity, an integer division per operation
+    HTUI32_REDUCTION_MODULO = 1,
+    // hash & (capacity - 1), capacity is rounded up to a power of two
+    HTUI32_REDUCTION_MASK = 2,
+    // Lemire's fastrange (hash * capacity) >> 32, any capacity up to 2^32, uses the high bits of the hash
+    HTUI32_REDUCTION_FASTRANGE = 3
+} htui32_reduction_t;
+
+// Memory allocator of the table, used for all table memory (buckets, slots and collision chain items)
+typedef struct {
+    // Allocates size bytes, returns NULL if the memory could not be allocated
+    void* (*alloc)(void* context, size_t size);
+    // Frees memory allocated by alloc, size is the same as it was passed to alloc
+    void (*free)(void* context, void* ptr, size_t size);
+    // User pointer passed to alloc and free
+    void* context;
+} htui32_allocator_t;
+
+// Collision chain items are taken from blocks of the item pool instead of being allocated one by one,
+// the memory of the pool is returned to the allocator only when the table is destroyed
+typedef struct {
+    // List of the pool blocks, linked through the first item of each block
+    hash_table_uint32_item_t* item_blocks_ptr;
+    // List of released items, they are used first
+    hash_table_uint32_item_t* free_items_ptr;
+    // Items of the last block that were never used
+    hash_table_uint32_item_t* block_items_begin;
+    hash_table_uint32_item_t* block_items_end;
+} htui32_item_pool_t;
+
+// Mode used when HTUI32_MODE_DEFAULT is requested, can be overridden at compile time
+#ifndef HTUI32_DEFAULT_MODE
+#define HTUI32_DEFAULT_MODE HTUI32_MODE_CHAINING
+#endif
+
+// Reduction used when HTUI32_REDUCTION_DEFAULT is requested, can be overridden at compile time
+#ifndef HTUI32_DEFAULT_REDUCTION
+#define HTUI32_DEFAULT_REDUCTION HTUI32_REDUCTION_MODULO
+#endif
+
+// Number of slots in a bucket of the cuckoo mode, 4 or 8 (an 8-slot bucket is one 64-byte cache line)
+#ifndef HTUI32_CUCKOO_BUCKET_SLOTS
+#define HTUI32_CUCKOO_BUCKET_SLOTS 8
+#endif
+
+// Define to 1 when building the library to count lookups, probe steps and rehashes in htui32_counters_t
+#ifndef HTUI32_STATS
+#define HTUI32_STATS 0
+#endif
+
+// Number of entries in the chain length histogram of htui32_stats_t, can be overridden at compile time (for the library and its users alike)
+#ifndef HTUI32_STATS_HISTOGRAM_SIZE
+#define HTUI32_STATS_HISTOGRAM_SIZE 16
+#endif
+
+// Lifetime counters of the table, they stay zero unless HTUI32_STATS is 1, so the hot path does not pay for them
+typedef struct {
+    // Number of times the capacity was increased
+    uint64_t grow_count;
+    // Number of times the capacity was reduced
+    uint64_t shrink_count;
+    // Time spent in growing and shrinking, including the steps of incremental rehashing
+    uint64_t rehash_time_ns;
+    // Number of key lookups made by puts, gets and deletes (the key 0 is not looked up)
+    uint64_t lookups_count;
+    // Number of collision chain items (open addressing slots, Swiss table groups) visited by the lookups
+    uint64_t probe_steps_count;
+} htui32_counters_t;
+
 typedef struct {
     // Total table capacity
     size_t capacity;
@@ -34,18 +151,158 @@ typedef struct {
     uint8_t load_fac_min;
     // Same as rehash_max_size, but related to reducing capacity and rehashing
     size_t rehash_min_size;
+    // Percentage of load_fac_max below which the load must stay after reducing capacity
+    uint8_t load_fac_hysteresis;
+    // Percentage of the capacity the capacity is increased to (the capacity is divided by it when reduced)
+    uint16_t growth_fac;
+    // Deletes reduce the capacity, otherwise only htui32_compact does
+    bool auto_shrink;
+    // The slots are the caller's buffer given to htui32_init_fixed, the table never allocates, frees or resizes them
+    bool fixed_buffer;
+    // Hard capacity of the table in the caller's buffer: the maximum number of keys, including the key 0
+    size_t fixed_max_size;
 
     // Pointer to table data
     hash_table_uint32_item_t* memory_ptr;
+    // Pointer to table data of the open addressing modes (memory_ptr is NULL in these modes)
+    hash_table_uint32_slot_t* slots_ptr;
+    // Pointer to control bytes of the Swiss table mode, located right after the slots
+    uint8_t* ctrl_ptr;
+    // Number of DELETED control bytes in the Swiss table mode
+    size_t deleted_count;
+    // Mapped snapshot file of the snapshot mode, the buckets and collision chain items are read from it in place
+    const void* snapshot_ptr;
+    // Size of the mapped snapshot file in bytes
+    size_t snapshot_size;
+    // Pilots of the buckets of the frozen mode, located right after the slots, the pilot moves all keys of its bucket to their own slots
+    uint16_t* pilots_ptr;
+    // Number of buckets (pilots) of the frozen mode
+    size_t pilots_count;
+    // Number of the first buckets of the frozen mode that get 60% of the keys
+    size_t dense_pilots_count;
+    // Seed of the hashes of the frozen mode
+    uint32_t frozen_seed;
+    // Collision chain items of the compact chaining mode (slots_ptr holds its buckets)
+    hash_table_uint32_overflow_item_t* overflow_ptr;
+    // Number of items in overflow_ptr
+    uint32_t overflow_capacity;
+    // Number of items of overflow_ptr that were ever used, the rest of them were never used
+    uint32_t overflow_used;
+    // Index of the first free item of overflow_ptr plus 1 (0 if there is none), free items are linked by next
+    uint32_t overflow_free;
+    // Memory of the cuckoo mode, slots_ptr is aligned to the bucket size in it
+    void* cuckoo_memory_ptr;
+
+    // Rehash the chaining mode table incrementally, a few buckets per put and delete
+    bool incremental_rehash;
+    // Memory which items are being moved from during incremental rehashing (NULL if there is no rehashing in progress)
+    hash_table_uint32_item_t* old_memory_ptr;
+    // Number of buckets in old_memory_ptr
+    size_t old_capacity;
+    // Number of the old buckets that are already moved to memory_ptr
+    size_t rehash_pos;
+    // Number of the first buckets of memory_ptr that are cleared, it is capacity except at the start of incremental rehashing,
+    // which clears memory_ptr a few buckets at a time before the first old bucket is moved (the rest have no keys until then)
+    size_t cleared_count;
+    // Number of buckets cleared or moved by each put and delete during incremental rehashing
+    size_t rehash_step;
+
+    // Collision chain items
+    htui32_item_pool_t item_pool;
     // Current table size in bytes
     size_t memory_size;
 
+    // Collision resolution strategy
+    htui32_mode_t mode;
+    // Bucket position of a hash
+    htui32_reduction_t reduction;
+    // Memory allocator
+    htui32_allocator_t allocator;
+
     // Indicates whether the table contains the key 0
     bool zero_key_is_used;
     // The key value 0 is not stored in the table like regular keys, it is stored in this variable
     uint32_t zero_key_value;
+
+    // Lifetime counters (updated only if HTUI32_STATS is 1)
+    htui32_counters_t counters;
 } hash_table_uint32_t;
 
+// Table parameters for htui32_init_ex, zero in any field means the default value
+typedef struct {
+    // Initial total size of the hash table (The hash table will not shrink to less than this initial capacity!)
+    size_t capacity;
+    // Percentage of the hash table load, at which its size will decrease and rehashing will be performed
+    uint8_t load_fac_min;
+    // Percentage of the hash table load, at which its size will increase and rehashing will be performed
+    uint8_t load_fac_max;
+    // The size decreases only if the load after that stays this many percent below load_fac_max (10 by default),
+    // so a put right after a delete (or the other way around) never grows and shrinks the table over and over
+    uint8_t load_fac_hysteresis;
+    // Percentage of the capacity the size increases to (200 by default, must be over 100),
+    // the Swiss table mode and the mask reduction always double the capacity
+    uint16_t growth_fac;
+    // Deletes do not decrease the size, only htui32_compact does
+    bool disable_auto_shrink;
+    // Collision resolution strategy
+    htui32_mode_t mode;
+    // Bucket position of a hash (the Swiss table mode always uses a power of two capacity and a mask)
+    htui32_reduction_t reduction;
+    // Chaining mode only: move a bounded number of buckets per put and delete instead of rehashing the whole table at once
+    bool incremental_rehash;
+    // Memory allocator, it is copied to the table (NULL for malloc and free)
+    const htui32_allocator_t* allocator;
+} htui32_config_t;
+
+/*
+ * Snapshot of the table state returned by htui32_stats
+ * A chain is the collision chain of a bucket in the chaining mode, the probe sequence of a key in the open addressing modes
+ * (its length is the number of slots probed to find the key) and of the groups in the Swiss table mode (the number of groups probed).
+ * The key 0 is not stored in a bucket and is not counted in the chains.
+ */
+typedef struct {
+    // Number of keys
+    size_t size;
+    // Number of buckets (slots)
+    size_t capacity;
+    // Chaining mode: buckets with at least one key, open addressing modes: used slots
+    size_t used_buckets;
+    // Length of the longest chain
+    size_t max_chain_length;
+    // Mean length of the chains of used_buckets multiplied by 100 (the table does not use floating point)
+    size_t mean_chain_length_x100;
+    // Entry i is the number of chains of length i, the last entry also counts all longer chains
+    size_t chain_length_histogram[HTUI32_STATS_HISTOGRAM_SIZE];
+    // Collision chain items allocated from the item pool and linked into the chains
+    size_t overflow_items;
+    // All memory of the table in bytes: buckets (slots), the old buckets of incremental rehashing and the item pool blocks
+    size_t memory_bytes;
+    // True if the library counts the lifetime counters (HTUI32_STATS is 1)
+    bool counters_enabled;
+    htui32_counters_t counters;
+} htui32_stats_t;
+
+// Receives a key and its value from htui32_foreach
+typedef void (*htui32_foreach_func_t)(void* context, uint32_t key, uint32_t value);
+
+/*
+ * Cursor over the keys of the table, see htui32_iter_init
+ * Positions are 0 for the key 0, then the buckets of the old memory during incremental rehashing, then the buckets (slots)
+ */
+typedef struct {
+    hash_table_uint32_t* ht_ptr;
+    // Position of the bucket and of the key in its collision chain that are read next
+    size_t pos;
+    size_t chain_index;
+    // Position of the key returned by the last htui32_iter_next, htui32_iter_delete moves the cursor back to it
+    size_t current_pos;
+    size_t current_chain_index;
+    uint32_t current_key;
+    bool has_current;
+    // Open addressing modes scan the slots from a free one, so backward shifting never moves a key from behind the cursor
+    size_t start_slot;
+} htui32_iter_t;
+
 // Short names for functions
 
 /*
@@ -58,14 +315,47 @@ typedef struct {
  */
 extern void htui32_init(hash_table_uint32_t* ht_ptr, size_t capacity, uint8_t load_fac_min, uint8_t load_fac_max);
 
+/*
+ * Initializes the table with extended parameters
+ *
+ * ht_ptr - pointer to hash table
+ * config_ptr - pointer to table parameters (NULL for default values)
+ */
+extern void htui32_init_ex(hash_table_uint32_t* ht_ptr, const htui32_config_t* config_ptr);
+
+/*
+ * Initializes the fixed-capacity table in the caller's buffer, the table never calls the allocator
+ * config_ptr->capacity is the hard capacity: the maximum number of keys (including the key 0), it must not be 0.
+ * Only the open addressing modes (linear probing, Robin Hood and Swiss table) can use a buffer, their slots are the buffer itself,
+ * so it can be static storage or a huge page. The buffer must be aligned to 4 bytes, htui32_destroy leaves it to the caller.
+ * Puts of new keys return false once the table is full, deletes never shrink it.
+ * Returns false if the mode cannot use a buffer or the buffer is smaller than htui32_fixed_buffer_size, the table is unusable then
+ *
+ * ht_ptr - pointer to hash table
+ * config_ptr - pointer to table parameters
+ * buffer - memory of the table
+ * buffer_size - size of the buffer in bytes
+ */
+extern bool htui32_init_fixed(hash_table_uint32_t* ht_ptr, const htui32_config_t* config_ptr, void* buffer, size_t buffer_size);
+
+/*
+ * Returns the size of the buffer in bytes that htui32_init_fixed needs for the table parameters,
+ * or 0 if the mode cannot use a buffer or the capacity is 0
+ *
+ * config_ptr - pointer to table parameters
+ */
+extern size_t htui32_fixed_buffer_size(const htui32_config_t* config_ptr);
+
 /*
  * Puts value by key in table
+ * Returns false if the key is new and could not be put: the memory could not be allocated or the fixed-capacity table is full.
+ * An existing key always gets the value.
  *
  * ht_ptr - pointer to hash table
  * key - key
  * value - value
  */
-extern void htui32_put(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t value);
+extern bool htui32_put(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t value);
 
 /*
  * Gets value by key from table
@@ -85,6 +375,200 @@ extern bool htui32_get(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t* valu
  */
 extern void htui32_delete(hash_table_uint32_t* ht_ptr, uint32_t key);
 
+/*
+ * Returns a pointer to the value of the key, the key is put with value first if it is not in the table
+ * The key is hashed once and found or placed with one traversal (two only when the new key grows the table).
+ * The pointer is valid until the next put, delete or other change of the table.
+ * Returns NULL if the key is new and could not be put (see htui32_put)
+ *
+ * ht_ptr - pointer to hash table
+ * key - key
+ * value - value of the new key
+ */
+extern uint32_t* htui32_get_or_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t value);
+
+/*
+ * Puts value by key only if the key is not in the table yet, with one traversal like htui32_get_or_insert
+ * Returns true if the key was put, false if it was already in the table (its value is not changed) or could not be put
+ *
+ * ht_ptr - pointer to hash table
+ * key - key
+ * value - value
+ */
+extern bool htui32_insert_if_absent(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t value);
+
+/*
+ * Adds delta to the value of the key with one traversal like htui32_get_or_insert, a new key is put with delta (it starts from 0)
+ * The value wraps around modulo 2^32, so (uint32_t)-1 decrements it.
+ * Returns false if the key is new and could not be put
+ *
+ * ht_ptr - pointer to hash table
+ * key - key
+ * delta - value to add
+ * old_value_ptr - pointer where the value before the addition will be placed, 0 for a new key (can be NULL)
+ */
+extern bool htui32_fetch_add(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t delta, uint32_t* old_value_ptr);
+
+/*
+ * Sets the value of the key to new_value if it is expected_value now, with one traversal, a missing key is not put
+ * Returns true if the value was set
+ *
+ * ht_ptr - pointer to hash table
+ * key - key
+ * expected_value - value the key must have
+ * new_value - value to set
+ */
+extern bool htui32_compare_and_set(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t expected_value, uint32_t new_value);
+
+/*
+ * Gets values by count keys from table
+ * The keys are hashed and their memory is prefetched in chunks before lookup, so cache misses of different keys overlap
+ *
+ * ht_ptr - pointer to hash table
+ * keys - keys
+ * values - array of count values, a value is written only if its key is found (NULL if only the presence of the keys is needed)
+ * found - array of count results, true if the key is found (can be NULL)
+ */
+extern void htui32_get_batch(hash_table_uint32_t* ht_ptr, const uint32_t* keys, uint32_t* values, bool* found, size_t count);
+
+/*
+ * Puts count values by keys in table, same as htui32_put for each key in order
+ * Returns false if any of the keys could not be put, the keys after it are still put
+ *
+ * ht_ptr - pointer to hash table
+ * keys - keys
+ * values - values
+ */
+extern bool htui32_put_batch(hash_table_uint32_t* ht_ptr, const uint32_t* keys, const uint32_t* values, size_t count);
+
+/*
+ * Deletes values by count keys from table, same as htui32_delete for each key in order
+ *
+ * ht_ptr - pointer to hash table
+ * keys - keys
+ */
+extern void htui32_delete_batch(hash_table_uint32_t* ht_ptr, const uint32_t* keys, size_t count);
+
+/*
+ * Increases the capacity at once, so that the table holds count keys without growing
+ * The capacity is never reduced by this function, but deletes can shrink the table again
+ * Returns false if the memory could not be allocated, the table is left unchanged in this case
+ *
+ * ht_ptr - pointer to hash table
+ * count - number of keys
+ */
+extern bool htui32_reserve(hash_table_uint32_t* ht_ptr, size_t count);
+
+/*
+ * Reduces the capacity to the smallest one at which the load is load_fac_hysteresis below load_fac_max,
+ * but not less than the initial capacity. It also completes incremental rehashing and gets rid of the DELETED slots of the Swiss table mode.
+ * The collision chain item pool keeps its memory.
+ * Returns false if the memory could not be allocated, all keys stay in the table in this case,
+ * but incremental rehashing may be left in progress
+ *
+ * ht_ptr - pointer to hash table
+ */
+extern bool htui32_compact(hash_table_uint32_t* ht_ptr);
+
+/*
+ * Puts count keys with their values in table, the table is resized once beforehand
+ * The keys must be unique and must not be in the table yet, they are not looked up, so duplicates are not detected
+ * Returns false if the memory could not be allocated, the keys before the failed one are put in this case
+ *
+ * ht_ptr - pointer to hash table
+ * keys - keys
+ * values - values
+ */
+extern bool htui32_build(hash_table_uint32_t* ht_ptr, const uint32_t* keys, const uint32_t* values, size_t count);
+
+/*
+ * Starts the iteration over all keys of the table, the key 0 comes first, then the keys in the order of the buckets (slots)
+ * The table must not be changed during the iteration, except by htui32_iter_delete.
+ *
+ * iter_ptr - pointer to iterator
+ * ht_ptr - pointer to hash table
+ */
+extern void htui32_iter_init(htui32_iter_t* iter_ptr, hash_table_uint32_t* ht_ptr);
+
+/*
+ * Moves the iterator to the next key
+ * Returns false if there are no more keys
+ *
+ * iter_ptr - pointer to iterator
+ * key_ptr - pointer where the key will be placed
+ * value_ptr - pointer where the value will be placed (can be NULL)
+ */
+extern bool htui32_iter_next(htui32_iter_t* iter_ptr, uint32_t* key_ptr, uint32_t* value_ptr);
+
+/*
+ * Deletes the key returned by the last htui32_iter_next, the iteration goes on with the next key,
+ * every other key is still returned exactly once. The table does not shrink during the iteration, the next delete shrinks it.
+ * Returns false if there is no current key (it was deleted already or the iteration has not started) or the table is read-only
+ *
+ * iter_ptr - pointer to iterator
+ */
+extern bool htui32_iter_delete(htui32_iter_t* iter_ptr);
+
+/*
+ * Calls func for every key of the table, the key 0 first, then one pass over the buckets (slots) in memory order
+ * func must not change the table, use the iterator to delete keys while walking them.
+ *
+ * ht_ptr - pointer to hash table
+ * func - function receiving the keys and values
+ * context - pointer passed to func
+ */
+extern void htui32_foreach(hash_table_uint32_t* ht_ptr, htui32_foreach_func_t func, void* context);
+
+/*
+ * Copies up to max_count keys and their values to the arrays in the htui32_iter_next order
+ * Returns the number of copied keys, it is less than the table size only if max_count is
+ *
+ * ht_ptr - pointer to hash table
+ * keys - array of max_count keys
+ * values - array of max_count values (can be NULL)
+ * max_count - size of the arrays
+ */
+extern size_t htui32_export(hash_table_uint32_t* ht_ptr, uint32_t* keys, uint32_t* values, size_t max_count);
+
+
+/*
+ * Writes the table to the snapshot file, which htui32_open_mmap maps without rebuilding the table
+ * The file is position-independent: collision chains are linked by indexes instead of pointers,
+ * its header keeps the format version and the hash function the buckets were computed with.
+ * Returns false if the memory could not be allocated or the file could not be written
+ *
+ * ht_ptr - pointer to hash table
+ * path - path of the file, it is overwritten
+ */
+extern bool htui32_save(hash_table_uint32_t* ht_ptr, const char* path);
+
+/*
+ * Initializes the read-only table mapped from the snapshot file written by htui32_save
+ * Gets read the mapping in place, puts, deletes and the other functions that change the table do nothing,
+ * htui32_destroy unmaps the file.
+ * Returns false if the file could not be mapped, it is not a snapshot, or it was written with another format version or hash function
+ *
+ * ht_ptr - pointer to hash table
+ * path - path of the file
+ */
+extern bool htui32_open_mmap(hash_table_uint32_t* ht_ptr, const char* path);
+
+/*
+ * Converts the table to the read-only frozen mode built on a minimal perfect hash (PTHash)
+ * Every key gets its own slot, which is found by the pilot of the key's bucket, so a get reads one pilot and compares one slot.
+ * The table takes about 8 bytes per key plus 4 bits of pilots, there are no collision chains and no spare capacity.
+ * Puts, deletes and the other functions that change the table do nothing after that.
+ * Returns false if the memory could not be allocated or the pilots could not be found, the table is left as it was then
+ *
+ * ht_ptr - pointer to hash table
+ */
+extern bool htui32_freeze(hash_table_uint32_t* ht_ptr);
+
+/*
+ * Same as htui32_get, for a table converted by htui32_freeze only, without dispatching on the table mode
+ * Returns false for a table of any other mode
+ */
+extern bool htui32_frozen_get(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t* value_ptr);
 
 /*
  * Frees up the memory allocated for hash table
@@ -93,6 +577,14 @@ extern void htui32_delete(hash_table_uint32_t* ht_ptr, uint32_t key);
  */
 extern void htui32_destroy(hash_table_uint32_t* ht_ptr);
 
+/*
+ * Fills stats_ptr with the table statistics, every bucket is visited, so it takes time proportional to the capacity
+ *
+ * ht_ptr - pointer to hash table
+ * stats_ptr - pointer to statistics
+ */
+extern void htui32_stats(hash_table_uint32_t* ht_ptr, htui32_stats_t* stats_ptr);
+
 /*
  * Prints the internal representation of the hash table
  * for example:
@@ -105,4 +597,8 @@ extern void htui32_destroy(hash_table_uint32_t* ht_ptr);
  */
 extern void htui32_print_iternal_rep(hash_table_uint32_t* ht_ptr);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
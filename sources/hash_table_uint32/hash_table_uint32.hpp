@@ -0,0 +1,446 @@
+#ifndef _HASH_TABLE_UINT32_HPP_
+#define _HASH_TABLE_UINT32_HPP_
+
+/*
+ * Header-only C++ version of the hash table: htui32::HashTable<Key, Value, Hash, Reduction>.
+ * It uses open addressing with linear probing and backward shift deletion like HTUI32_MODE_LINEAR_PROBING,
+ * but the hash and the reduction are template parameters, so they are inlined into every operation
+ * instead of being selected at run time behind the C interface.
+ *
+ * Like in the C table, the default constructed key (0 for integers) marks an empty slot
+ * and is stored in a separate slot of its own, so every key value can be used.
+ * Key and Value must be default constructible and movable, Key must be comparable with ==.
+ *
+ * Keys and values can be of any width, HashTableUInt64 and PointerMap are the 64-bit variants of the C table
+ * (for example, object addresses mapped to slab descriptors), the null pointer is the key kept in the separate slot.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+extern "C" {
+#include "hash_table_uint32_hash.h"
+}
+
+namespace htui32 {
+
+// Hash policies, each one maps a key to a 32-bit hash like htui32_hash
+
+// MurmurHash3 finalizer, the default for keys of up to 32 bits
+struct Fmix32Hash {
+    uint32_t operator()(uint32_t key) const { return htui32_hash_fmix32(key); }
+};
+
+// Multiplication by the golden ratio, the cheapest one
+struct MultiplyShiftHash {
+    uint32_t operator()(uint32_t key) const { return htui32_hash_multiply_shift(key); }
+};
+
+// MurmurHash3 64-bit finalizer with the halves of the result folded, the default for 64-bit keys
+struct Fmix64Hash {
+    uint32_t operator()(uint64_t key) const
+    {
+        key ^= key >> 33;
+        key *= 0xff51afd7ed558ccdULL;
+        key ^= key >> 33;
+        key *= 0xc4ceb9fe1a85ec53ULL;
+        key ^= key >> 33;
+        return (uint32_t)key ^ (uint32_t)(key >> 32);
+    }
+};
+
+// Default hash policy of the key type
+template <typename Key, typename Enable = void>
+struct DefaultHash;
+
+template <typename Key>
+struct DefaultHash<Key, typename std::enable_if<std::is_integral<Key>::value && sizeof(Key) <= 4>::type> : Fmix32Hash {
+};
+
+template <typename Key>
+struct DefaultHash<Key, typename std::enable_if<std::is_integral<Key>::value && sizeof(Key) == 8>::type> : Fmix64Hash {
+};
+
+// Pointers are hashed as their address, the low bits of aligned addresses are always zero, so the finalizer must mix the high bits in
+template <typename Pointee>
+struct DefaultHash<Pointee*> {
+    uint32_t operator()(Pointee* key) const { return DefaultHash<uintptr_t>()((uintptr_t)key); }
+};
+
+// Reduction policies, each one maps a hash to a slot position like htui32_reduction_t
+
+// hash & (capacity - 1), the capacity is always a power of two
+struct MaskReduction {
+    static constexpr bool power_of_two = true;
+    static size_t reduce(uint32_t hash, size_t capacity) { return hash & (capacity - 1); }
+};
+
+// hash % capacity
+struct ModuloReduction {
+    static constexpr bool power_of_two = false;
+    static size_t reduce(uint32_t hash, size_t capacity) { return hash % capacity; }
+};
+
+// Lemire's fastrange (hash * capacity) >> 32
+struct FastrangeReduction {
+    static constexpr bool power_of_two = false;
+    static size_t reduce(uint32_t hash, size_t capacity) { return (size_t)(((uint64_t)hash * capacity) >> 32); }
+};
+
+template <typename Key, typename Value, typename Hash = DefaultHash<Key>, typename Reduction = MaskReduction>
+class HashTable {
+public:
+    // Item of the table, iterators point to it
+    struct Slot {
+        Key key;
+        Value value;
+    };
+
+    // Forward iterator over the used slots and then the slot of the empty key
+    template <typename TableType, typename SlotType>
+    class Iterator {
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef Slot value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef SlotType* pointer;
+        typedef SlotType& reference;
+
+        Iterator() : table_ptr_(nullptr), pos_(0) {}
+        Iterator(TableType* table_ptr, size_t pos) : table_ptr_(table_ptr), pos_(pos) { skip_unused(); }
+
+        reference operator*() const { return *table_ptr_->slot_at(pos_); }
+        pointer operator->() const { return table_ptr_->slot_at(pos_); }
+
+        Iterator& operator++()
+        {
+            ++pos_;
+            skip_unused();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const { return pos_ == other.pos_; }
+        bool operator!=(const Iterator& other) const { return pos_ != other.pos_; }
+
+    private:
+        void skip_unused()
+        {
+            while (pos_ < table_ptr_->end_pos() && !table_ptr_->pos_is_used(pos_)) {
+                ++pos_;
+            }
+        }
+
+        TableType* table_ptr_;
+        // Slot position, capacity is the position of the empty key slot
+        size_t pos_;
+    };
+
+    typedef Iterator<HashTable, Slot> iterator;
+    typedef Iterator<const HashTable, const Slot> const_iterator;
+
+    /*
+     * capacity - initial capacity, the table does not shrink below it (rounded up to a power of two for MaskReduction)
+     * load_fac_min, load_fac_max - percentages of the load at which the table shrinks and grows, same as in htui32_init
+     */
+    explicit HashTable(size_t capacity = 4, uint8_t load_fac_min = 25, uint8_t load_fac_max = 75)
+        : slots_(nullptr), capacity_(0), size_(0), load_fac_min_(load_fac_min), load_fac_max_(load_fac_max),
+          empty_key_is_used_(false), empty_key_slot_()
+    {
+        // At least one slot must stay free, otherwise probing for a missing key never stops
+        if (load_fac_max_ == 0 || load_fac_max_ > 99) {
+            load_fac_max_ = 75;
+        }
+        if (load_fac_min_ >= load_fac_max_) {
+            load_fac_min_ = load_fac_max_ / 3;
+        }
+        initial_capacity_ = round_capacity(capacity != 0 ? capacity : 4);
+        rehash(initial_capacity_);
+    }
+
+    ~HashTable() { delete[] slots_; }
+
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
+
+    HashTable(HashTable&& other) noexcept
+        : slots_(other.slots_), capacity_(other.capacity_), initial_capacity_(other.initial_capacity_), size_(other.size_),
+          load_fac_min_(other.load_fac_min_), load_fac_max_(other.load_fac_max_),
+          empty_key_is_used_(other.empty_key_is_used_), empty_key_slot_(std::move(other.empty_key_slot_))
+    {
+        other.slots_ = nullptr;
+        other.capacity_ = 0;
+        other.size_ = 0;
+        other.empty_key_is_used_ = false;
+        other.empty_key_slot_ = Slot();
+    }
+
+    HashTable& operator=(HashTable&& other) noexcept
+    {
+        if (this != &other) {
+            delete[] slots_;
+            slots_ = other.slots_;
+            capacity_ = other.capacity_;
+            initial_capacity_ = other.initial_capacity_;
+            size_ = other.size_;
+            load_fac_min_ = other.load_fac_min_;
+            load_fac_max_ = other.load_fac_max_;
+            empty_key_is_used_ = other.empty_key_is_used_;
+            empty_key_slot_ = std::move(other.empty_key_slot_);
+            other.slots_ = nullptr;
+            other.capacity_ = 0;
+            other.size_ = 0;
+            other.empty_key_is_used_ = false;
+            other.empty_key_slot_ = Slot();
+        }
+        return *this;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+
+    // Puts value by key, the value of an existing key is replaced
+    void put(const Key& key, Value value)
+    {
+        if (key == Key()) {
+            if (!empty_key_is_used_) {
+                empty_key_is_used_ = true;
+                size_++;
+            }
+            empty_key_slot_.value = std::move(value);
+            return;
+        }
+        uint32_t hash = Hash()(key);
+        Value* value_ptr = find_value(key, hash);
+        if (value_ptr != nullptr) {
+            *value_ptr = std::move(value);
+            return;
+        }
+        // A moved table has no slots, it starts over from the initial capacity
+        if (size_ + 1 >= rehash_max_size()) {
+            rehash(capacity_ != 0 ? capacity_ * 2 : initial_capacity_);
+        }
+        place(key, std::move(value), Reduction::reduce(hash, capacity_));
+        size_++;
+    }
+
+    // Returns a pointer to the value of the key or nullptr if the key is not in the table, the pointer is valid until the next put or erase
+    Value* find(const Key& key)
+    {
+        if (key == Key()) {
+            return empty_key_is_used_ ? &empty_key_slot_.value : nullptr;
+        }
+        return find_value(key, Hash()(key));
+    }
+
+    const Value* find(const Key& key) const { return const_cast<HashTable*>(this)->find(key); }
+
+    /*
+     * Gets value by key
+     * Returns true if the key is found, otherwise false
+     *
+     * value_ptr - pointer where the value will be placed, if found (can be nullptr)
+     */
+    bool get(const Key& key, Value* value_ptr) const
+    {
+        const Value* item_value_ptr = find(key);
+        if (item_value_ptr == nullptr) {
+            return false;
+        }
+        if (value_ptr != nullptr) {
+            *value_ptr = *item_value_ptr;
+        }
+        return true;
+    }
+
+    bool contains(const Key& key) const { return find(key) != nullptr; }
+
+    /*
+     * Deletes value by key, iterators and value pointers are invalidated since the following items are moved back
+     * Returns true if the key was in the table
+     */
+    bool erase(const Key& key)
+    {
+        if (key == Key()) {
+            if (!empty_key_is_used_) {
+                return false;
+            }
+            empty_key_is_used_ = false;
+            empty_key_slot_.value = Value();
+            size_--;
+        }
+        else {
+            size_t pos = 0;
+            if (!find_pos(key, Hash()(key), &pos)) {
+                return false;
+            }
+            remove_at(pos);
+            size_--;
+        }
+        check_and_shrink();
+        return true;
+    }
+
+    // Grows the table at once, so that it holds count keys without growing
+    void reserve(size_t count)
+    {
+        size_t new_capacity = round_capacity(count * 100 / load_fac_max_ + 1);
+        if (new_capacity > capacity_) {
+            rehash(new_capacity);
+        }
+    }
+
+    // Deletes all keys, the table shrinks to the initial capacity
+    void clear()
+    {
+        delete[] slots_;
+        slots_ = nullptr;
+        capacity_ = 0;
+        size_ = 0;
+        empty_key_is_used_ = false;
+        empty_key_slot_.value = Value();
+        rehash(initial_capacity_);
+    }
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, end_pos()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, end_pos()); }
+
+private:
+    size_t round_capacity(size_t capacity) const
+    {
+        if (!Reduction::power_of_two) {
+            return capacity;
+        }
+        size_t rounded = 1;
+        while (rounded < capacity) {
+            rounded *= 2;
+        }
+        return rounded;
+    }
+
+    // Same rounding as calculate_rehash_sizes of the C table
+    size_t rehash_max_size() const { return (capacity_ * load_fac_max_ + 99) / 100; }
+
+    size_t next_pos(size_t pos) const { return (pos + 1 == capacity_) ? 0 : pos + 1; }
+
+    bool find_pos(const Key& key, uint32_t hash, size_t* pos_ptr) const
+    {
+        if (capacity_ == 0) {
+            return false;
+        }
+        size_t pos = Reduction::reduce(hash, capacity_);
+        while (true) {
+            const Key& current_key = slots_[pos].key;
+            if (current_key == key) {
+                *pos_ptr = pos;
+                return true;
+            }
+            if (current_key == Key()) {
+                return false;
+            }
+            pos = next_pos(pos);
+        }
+    }
+
+    Value* find_value(const Key& key, uint32_t hash)
+    {
+        size_t pos = 0;
+        return find_pos(key, hash, &pos) ? &slots_[pos].value : nullptr;
+    }
+
+    // Puts the item to the first free slot starting from pos, there must be at least one free slot
+    void place(const Key& key, Value&& value, size_t pos)
+    {
+        while (!(slots_[pos].key == Key())) {
+            pos = next_pos(pos);
+        }
+        slots_[pos].key = key;
+        slots_[pos].value = std::move(value);
+    }
+
+    // Backward shift deletion, the same as htui32_open_remove for linear probing
+    void remove_at(size_t hole)
+    {
+        size_t pos = next_pos(hole);
+        while (!(slots_[pos].key == Key())) {
+            // The item can be moved to the hole only if its home position is not in (hole, pos]
+            size_t home = Reduction::reduce(Hash()(slots_[pos].key), capacity_);
+            bool can_move = (hole <= pos) ? (home <= hole || home > pos) : (home <= hole && home > pos);
+            if (can_move) {
+                slots_[hole] = std::move(slots_[pos]);
+                hole = pos;
+            }
+            pos = next_pos(pos);
+        }
+        slots_[hole].key = Key();
+        slots_[hole].value = Value();
+    }
+
+    // Shrinks the table like check_and_shrink_rehash of the C table with the default hysteresis of 10%
+    void check_and_shrink()
+    {
+        size_t new_capacity = capacity_ / 2;
+        if (new_capacity < initial_capacity_) {
+            return;
+        }
+        size_t used_slots = size_ - (empty_key_is_used_ ? 1 : 0);
+        size_t shrunk_load_fac_max = (load_fac_max_ > 10) ? load_fac_max_ - 10 : load_fac_max_;
+        if (used_slots * 100 <= capacity_ * load_fac_min_ && used_slots * 100 <= new_capacity * shrunk_load_fac_max) {
+            rehash(new_capacity);
+        }
+    }
+
+    void rehash(size_t new_capacity)
+    {
+        Slot* old_slots = slots_;
+        size_t old_capacity = capacity_;
+        slots_ = new Slot[new_capacity]();
+        capacity_ = new_capacity;
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (!(old_slots[i].key == Key())) {
+                place(old_slots[i].key, std::move(old_slots[i].value), Reduction::reduce(Hash()(old_slots[i].key), capacity_));
+            }
+        }
+        delete[] old_slots;
+    }
+
+    // Iterator positions: slots, then the empty key slot
+    size_t end_pos() const { return capacity_ + 1; }
+
+    bool pos_is_used(size_t pos) const { return (pos == capacity_) ? empty_key_is_used_ : !(slots_[pos].key == Key()); }
+
+    Slot* slot_at(size_t pos) { return (pos == capacity_) ? &empty_key_slot_ : &slots_[pos]; }
+    const Slot* slot_at(size_t pos) const { return (pos == capacity_) ? &empty_key_slot_ : &slots_[pos]; }
+
+    Slot* slots_;
+    size_t capacity_;
+    size_t initial_capacity_;
+    size_t size_;
+    uint8_t load_fac_min_;
+    uint8_t load_fac_max_;
+    // The default constructed key is not stored in the slots, it marks an empty slot
+    bool empty_key_is_used_;
+    Slot empty_key_slot_;
+};
+
+// 64-bit keys and values
+typedef HashTable<uint64_t, uint64_t> HashTableUInt64;
+
+// Object addresses as keys
+template <typename Value>
+using PointerMap = HashTable<const void*, Value>;
+
+}
+
+#endif
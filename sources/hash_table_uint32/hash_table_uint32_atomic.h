@@ -0,0 +1,66 @@
+#ifndef _HASH_TABLE_UINT32_ATOMIC_
+#define _HASH_TABLE_UINT32_ATOMIC_
+
+/*
+ * Atomic accesses of the concurrent table.
+ * The fields that lockless gets read while a writer may change them are accessed only through these functions.
+ * It is not a part of the public interface.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+// Aligned volatile accesses are atomic with MSVC, the barriers keep the compiler (and ARM processors) from reordering them
+#if defined(_M_ARM) || defined(_M_ARM64)
+#define HTUI32_BARRIER() __dmb(0xB)
+#else
+#define HTUI32_BARRIER() _ReadWriteBarrier()
+#endif
+
+static inline size_t htui32_atomic_load(const size_t* ptr) { return *(const volatile size_t*)ptr; }
+static inline void htui32_atomic_store(size_t* ptr, size_t value) { *(volatile size_t*)ptr = value; }
+static inline size_t htui32_atomic_load_acquire(const size_t* ptr) { size_t value = *(const volatile size_t*)ptr; HTUI32_BARRIER(); return value; }
+static inline size_t htui32_atomic_load_seq_cst(const size_t* ptr) { HTUI32_BARRIER(); size_t value = *(const volatile size_t*)ptr; HTUI32_BARRIER(); return value; }
+static inline void htui32_atomic_store_release(size_t* ptr, size_t value) { HTUI32_BARRIER(); *(volatile size_t*)ptr = value; }
+#if defined(_WIN64)
+static inline size_t htui32_atomic_add(size_t* ptr, size_t value) { return (size_t)_InterlockedExchangeAdd64((volatile __int64*)ptr, (__int64)value); }
+#else
+static inline size_t htui32_atomic_add(size_t* ptr, size_t value) { return (size_t)_InterlockedExchangeAdd((volatile long*)ptr, (long)value); }
+#endif
+static inline uint32_t htui32_atomic_load_u32(const uint32_t* ptr) { return *(const volatile uint32_t*)ptr; }
+static inline void htui32_atomic_store_u32(uint32_t* ptr, uint32_t value) { *(volatile uint32_t*)ptr = value; }
+static inline bool htui32_atomic_load_bool(const bool* ptr) { return *(const volatile bool*)ptr; }
+static inline void htui32_atomic_store_bool(bool* ptr, bool value) { *(volatile bool*)ptr = value; }
+static inline void* htui32_atomic_load_ptr(void* const* ptr) { return *(void* const volatile*)ptr; }
+static inline void htui32_atomic_store_ptr(void** ptr, void* value) { *(void* volatile*)ptr = value; }
+static inline void* htui32_atomic_load_ptr_seq_cst(void* const* ptr) { HTUI32_BARRIER(); void* value = *(void* const volatile*)ptr; HTUI32_BARRIER(); return value; }
+static inline void htui32_atomic_store_ptr_seq_cst(void** ptr, void* value) { _InterlockedExchangePointer((void* volatile*)ptr, value); }
+static inline void htui32_atomic_fence_acquire(void) { HTUI32_BARRIER(); }
+static inline void htui32_atomic_fence_release(void) { HTUI32_BARRIER(); }
+
+#else
+
+static inline size_t htui32_atomic_load(const size_t* ptr) { return __atomic_load_n(ptr, __ATOMIC_RELAXED); }
+static inline void htui32_atomic_store(size_t* ptr, size_t value) { __atomic_store_n(ptr, value, __ATOMIC_RELAXED); }
+static inline size_t htui32_atomic_load_acquire(const size_t* ptr) { return __atomic_load_n(ptr, __ATOMIC_ACQUIRE); }
+static inline size_t htui32_atomic_load_seq_cst(const size_t* ptr) { return __atomic_load_n(ptr, __ATOMIC_SEQ_CST); }
+static inline void htui32_atomic_store_release(size_t* ptr, size_t value) { __atomic_store_n(ptr, value, __ATOMIC_RELEASE); }
+static inline size_t htui32_atomic_add(size_t* ptr, size_t value) { return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST); }
+static inline uint32_t htui32_atomic_load_u32(const uint32_t* ptr) { return __atomic_load_n(ptr, __ATOMIC_RELAXED); }
+static inline void htui32_atomic_store_u32(uint32_t* ptr, uint32_t value) { __atomic_store_n(ptr, value, __ATOMIC_RELAXED); }
+static inline bool htui32_atomic_load_bool(const bool* ptr) { return __atomic_load_n(ptr, __ATOMIC_RELAXED); }
+static inline void htui32_atomic_store_bool(bool* ptr, bool value) { __atomic_store_n(ptr, value, __ATOMIC_RELAXED); }
+static inline void* htui32_atomic_load_ptr(void* const* ptr) { return __atomic_load_n(ptr, __ATOMIC_RELAXED); }
+static inline void htui32_atomic_store_ptr(void** ptr, void* value) { __atomic_store_n(ptr, value, __ATOMIC_RELAXED); }
+static inline void* htui32_atomic_load_ptr_seq_cst(void* const* ptr) { return __atomic_load_n(ptr, __ATOMIC_SEQ_CST); }
+static inline void htui32_atomic_store_ptr_seq_cst(void** ptr, void* value) { __atomic_store_n(ptr, value, __ATOMIC_SEQ_CST); }
+static inline void htui32_atomic_fence_acquire(void) { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
+static inline void htui32_atomic_fence_release(void) { __atomic_thread_fence(__ATOMIC_RELEASE); }
+
+#endif
+
+#endif
@@ -0,0 +1,309 @@
+#include "hash_table_uint32_internal.h"
+#include <string.h>
+
+/*
+ * Compact chaining mode of the hash table.
+ * Buckets are 8-byte slots in slots_ptr, a bucket is in one of three states:
+ * empty (key 0, value 0), a single key (key and value in place), or a collision chain (key 0, value is the index of
+ * the first chain item plus 1). A bucket with a chain keeps all its keys in the chain, so the key 0 never needs a mark.
+ * Chain items are 12 bytes in overflow_ptr, they are linked by 32-bit indexes and reused through a free list,
+ * the array is moved as a whole when it grows.
+ */
+
+// Number of chain items allocated first
+#define OVERFLOW_MIN_CAPACITY 16
+
+static inline bool bucket_has_chain(const hash_table_uint32_slot_t* bucket)
+{
+    return bucket->key == 0 && bucket->value != 0;
+}
+
+// Returns the index of a free chain item plus 1, or 0 if the memory could not be allocated, overflow_ptr can move
+static uint32_t alloc_overflow_item(hash_table_uint32_t* ht_ptr)
+{
+    if (ht_ptr->overflow_free != 0) {
+        uint32_t index = ht_ptr->overflow_free;
+        ht_ptr->overflow_free = ht_ptr->overflow_ptr[index - 1].next;
+        return index;
+    }
+    if (ht_ptr->overflow_used == ht_ptr->overflow_capacity) {
+        // Indexes plus 1 must fit into 32 bits
+        if (ht_ptr->overflow_capacity >= UINT32_MAX / 2) {
+            return 0;
+        }
+        uint32_t new_capacity = (ht_ptr->overflow_capacity != 0) ? ht_ptr->overflow_capacity * 2 : OVERFLOW_MIN_CAPACITY;
+        hash_table_uint32_overflow_item_t* new_overflow = alloc_func(ht_ptr, new_capacity * sizeof(hash_table_uint32_overflow_item_t));
+        if (new_overflow == NULL) {
+            return 0;
+        }
+        if (ht_ptr->overflow_ptr != NULL) {
+            memcpy(new_overflow, ht_ptr->overflow_ptr, ht_ptr->overflow_used * sizeof(hash_table_uint32_overflow_item_t));
+            free_func(ht_ptr, ht_ptr->overflow_ptr, ht_ptr->overflow_capacity * sizeof(hash_table_uint32_overflow_item_t));
+        }
+        ht_ptr->memory_size += (new_capacity - ht_ptr->overflow_capacity) * sizeof(hash_table_uint32_overflow_item_t);
+        ht_ptr->overflow_ptr = new_overflow;
+        ht_ptr->overflow_capacity = new_capacity;
+    }
+    return ++ht_ptr->overflow_used;
+}
+
+static inline void free_overflow_item(hash_table_uint32_t* ht_ptr, uint32_t index)
+{
+    ht_ptr->overflow_ptr[index - 1].next = ht_ptr->overflow_free;
+    ht_ptr->overflow_free = index;
+}
+
+uint32_t* htui32_compact_chaining_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    hash_table_uint32_slot_t* bucket = &ht_ptr->slots_ptr[htui32_reduce(ht_ptr, hash, ht_ptr->capacity)];
+    HTUI32_COUNT(ht_ptr, lookups_count, 1);
+    HTUI32_COUNT(ht_ptr, probe_steps_count, 1);
+    if (bucket->key == key) {
+        return &bucket->value;
+    }
+    if (!bucket_has_chain(bucket)) {
+        return NULL;
+    }
+    for (uint32_t index = bucket->value; index != 0;) {
+        hash_table_uint32_overflow_item_t* item = &ht_ptr->overflow_ptr[index - 1];
+        HTUI32_COUNT(ht_ptr, probe_steps_count, 1);
+        if (item->key == key) {
+            return &item->value;
+        }
+        index = item->next;
+    }
+    return NULL;
+}
+
+/*
+ * Puts a new key to the bucket, the key must not be in the table
+ * Returns a pointer to its value or NULL if the memory could not be allocated
+ */
+static uint32_t* bucket_insert(hash_table_uint32_t* ht_ptr, hash_table_uint32_slot_t* bucket, uint32_t key, uint32_t value)
+{
+    if (bucket->key == 0 && bucket->value == 0) {
+        bucket->key = key;
+        bucket->value = value;
+        return &bucket->value;
+    }
+    uint32_t index = alloc_overflow_item(ht_ptr);
+    if (index == 0) {
+        return NULL;
+    }
+    uint32_t next = bucket->value;
+    if (!bucket_has_chain(bucket)) {
+        // The key of the bucket moves to the new chain
+        next = alloc_overflow_item(ht_ptr);
+        if (next == 0) {
+            free_overflow_item(ht_ptr, index);
+            return NULL;
+        }
+        ht_ptr->overflow_ptr[next - 1].key = bucket->key;
+        ht_ptr->overflow_ptr[next - 1].value = bucket->value;
+        ht_ptr->overflow_ptr[next - 1].next = 0;
+        bucket->key = 0;
+    }
+    ht_ptr->overflow_ptr[index - 1].key = key;
+    ht_ptr->overflow_ptr[index - 1].value = value;
+    ht_ptr->overflow_ptr[index - 1].next = next;
+    bucket->value = index;
+    return &ht_ptr->overflow_ptr[index - 1].value;
+}
+
+bool htui32_compact_chaining_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value)
+{
+    return bucket_insert(ht_ptr, &ht_ptr->slots_ptr[htui32_reduce(ht_ptr, hash, ht_ptr->capacity)], key, value) != NULL;
+}
+
+uint32_t* htui32_compact_chaining_find_or_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, bool* is_inserted_ptr)
+{
+    hash_table_uint32_slot_t* bucket = &ht_ptr->slots_ptr[htui32_reduce(ht_ptr, hash, ht_ptr->capacity)];
+    HTUI32_COUNT(ht_ptr, lookups_count, 1);
+    HTUI32_COUNT(ht_ptr, probe_steps_count, 1);
+    if (bucket->key == key) {
+        return &bucket->value;
+    }
+    if (bucket_has_chain(bucket)) {
+        for (uint32_t index = bucket->value; index != 0;) {
+            hash_table_uint32_overflow_item_t* item = &ht_ptr->overflow_ptr[index - 1];
+            HTUI32_COUNT(ht_ptr, probe_steps_count, 1);
+            if (item->key == key) {
+                return &item->value;
+            }
+            index = item->next;
+        }
+    }
+    uint32_t* value_ptr = bucket_insert(ht_ptr, bucket, key, value);
+    *is_inserted_ptr = value_ptr != NULL;
+    return value_ptr;
+}
+
+bool htui32_compact_chaining_remove(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    hash_table_uint32_slot_t* bucket = &ht_ptr->slots_ptr[htui32_reduce(ht_ptr, hash, ht_ptr->capacity)];
+    if (bucket->key == key) {
+        bucket->key = 0;
+        bucket->value = 0;
+        return true;
+    }
+    if (!bucket_has_chain(bucket)) {
+        return false;
+    }
+    // Link to the item: the bucket value or the next field of the previous item
+    uint32_t* link = &bucket->value;
+    while (*link != 0 && ht_ptr->overflow_ptr[*link - 1].key != key) {
+        link = &ht_ptr->overflow_ptr[*link - 1].next;
+    }
+    if (*link == 0) {
+        return false;
+    }
+    uint32_t index = *link;
+    *link = ht_ptr->overflow_ptr[index - 1].next;
+    free_overflow_item(ht_ptr, index);
+    // A chain has at least two keys, the last one goes back to the bucket
+    hash_table_uint32_overflow_item_t* first_item = &ht_ptr->overflow_ptr[bucket->value - 1];
+    if (first_item->next == 0) {
+        index = bucket->value;
+        bucket->key = first_item->key;
+        bucket->value = first_item->value;
+        free_overflow_item(ht_ptr, index);
+    }
+    return true;
+}
+
+size_t htui32_compact_chaining_length(hash_table_uint32_t* ht_ptr, size_t pos)
+{
+    const hash_table_uint32_slot_t* bucket = &ht_ptr->slots_ptr[pos];
+    if (!bucket_has_chain(bucket)) {
+        return (bucket->key != 0) ? 1 : 0;
+    }
+    size_t length = 0;
+    for (uint32_t index = bucket->value; index != 0; index = ht_ptr->overflow_ptr[index - 1].next) {
+        length++;
+    }
+    return length;
+}
+
+bool htui32_compact_chaining_read(hash_table_uint32_t* ht_ptr, size_t pos, size_t chain_index, uint32_t* key_ptr, uint32_t* value_ptr)
+{
+    const hash_table_uint32_slot_t* bucket = &ht_ptr->slots_ptr[pos];
+    if (!bucket_has_chain(bucket)) {
+        *key_ptr = bucket->key;
+        *value_ptr = bucket->value;
+        return chain_index == 0;
+    }
+    uint32_t index = bucket->value;
+    for (; chain_index != 0 && index != 0; --chain_index) {
+        index = ht_ptr->overflow_ptr[index - 1].next;
+    }
+    if (index == 0) {
+        return false;
+    }
+    *key_ptr = ht_ptr->overflow_ptr[index - 1].key;
+    *value_ptr = ht_ptr->overflow_ptr[index - 1].value;
+    return true;
+}
+
+void htui32_compact_chaining_visit(hash_table_uint32_t* ht_ptr, htui32_item_visitor_t visitor, void* context)
+{
+    for (size_t i = 0; i < ht_ptr->capacity; ++i) {
+        const hash_table_uint32_slot_t* bucket = &ht_ptr->slots_ptr[i];
+        if (!bucket_has_chain(bucket)) {
+            if (bucket->key != 0) {
+                visitor(context, bucket->key, bucket->value);
+            }
+            continue;
+        }
+        for (uint32_t index = bucket->value; index != 0; index = ht_ptr->overflow_ptr[index - 1].next) {
+            visitor(context, ht_ptr->overflow_ptr[index - 1].key, ht_ptr->overflow_ptr[index - 1].value);
+        }
+    }
+}
+
+void htui32_compact_chaining_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash)
+{
+    htui32_prefetch(&ht_ptr->slots_ptr[htui32_reduce(ht_ptr, hash, ht_ptr->capacity)]);
+}
+
+// Counts the keys of every new bucket in its value, the buckets must be zeroed
+static void count_key(void* context, uint32_t key, uint32_t value)
+{
+    hash_table_uint32_t* new_ht_ptr = context;
+    (void)value;
+    new_ht_ptr->slots_ptr[htui32_reduce(new_ht_ptr, htui32_hash(key), new_ht_ptr->capacity)].value++;
+}
+
+// Puts the key to the new table, its chain items are all allocated, so it cannot fail
+static void move_key(void* context, uint32_t key, uint32_t value)
+{
+    htui32_compact_chaining_insert(context, key, htui32_hash(key), value);
+}
+
+bool htui32_compact_chaining_rehash(hash_table_uint32_t* ht_ptr, size_t new_capacity)
+{
+    // The new table is set up in a copy, so the old one stays intact until all memory is allocated
+    hash_table_uint32_t new_ht = *ht_ptr;
+    new_ht.capacity = new_capacity;
+    new_ht.slots_ptr = alloc_func(ht_ptr, new_capacity * sizeof(hash_table_uint32_slot_t));
+    if (new_ht.slots_ptr == NULL) {
+        return false;
+    }
+    memset(new_ht.slots_ptr, 0, new_capacity * sizeof(hash_table_uint32_slot_t));
+
+    // The chains of the new buckets take the keys of the buckets with more than one key,
+    // the spare half is for the next collisions, so the first of them does not copy the whole chain memory
+    size_t overflow_count = 0;
+    if (ht_ptr->slots_ptr != NULL) {
+        htui32_compact_chaining_visit(ht_ptr, count_key, &new_ht);
+        for (size_t i = 0; i < new_capacity; ++i) {
+            if (new_ht.slots_ptr[i].value > 1) {
+                overflow_count += new_ht.slots_ptr[i].value;
+            }
+        }
+        memset(new_ht.slots_ptr, 0, new_capacity * sizeof(hash_table_uint32_slot_t));
+    }
+    size_t overflow_capacity = 0;
+    if (overflow_count != 0) {
+        overflow_capacity = overflow_count + overflow_count / 2;
+        overflow_capacity = (overflow_capacity > OVERFLOW_MIN_CAPACITY) ? overflow_capacity : OVERFLOW_MIN_CAPACITY;
+    }
+    if (overflow_capacity >= UINT32_MAX / 2) {
+        free_func(ht_ptr, new_ht.slots_ptr, new_capacity * sizeof(hash_table_uint32_slot_t));
+        return false;
+    }
+    new_ht.overflow_capacity = (uint32_t)overflow_capacity;
+    new_ht.overflow_used = 0;
+    new_ht.overflow_free = 0;
+    new_ht.overflow_ptr = NULL;
+    if (overflow_capacity != 0) {
+        new_ht.overflow_ptr = alloc_func(ht_ptr, overflow_capacity * sizeof(hash_table_uint32_overflow_item_t));
+        if (new_ht.overflow_ptr == NULL) {
+            free_func(ht_ptr, new_ht.slots_ptr, new_capacity * sizeof(hash_table_uint32_slot_t));
+            return false;
+        }
+    }
+    new_ht.memory_size = new_capacity * sizeof(hash_table_uint32_slot_t) + overflow_capacity * sizeof(hash_table_uint32_overflow_item_t);
+    if (ht_ptr->slots_ptr != NULL) {
+        htui32_compact_chaining_visit(ht_ptr, move_key, &new_ht);
+    }
+
+    htui32_compact_chaining_free(ht_ptr);
+    ht_ptr->capacity = new_ht.capacity;
+    ht_ptr->slots_ptr = new_ht.slots_ptr;
+    ht_ptr->overflow_ptr = new_ht.overflow_ptr;
+    ht_ptr->overflow_capacity = new_ht.overflow_capacity;
+    ht_ptr->overflow_used = new_ht.overflow_used;
+    ht_ptr->overflow_free = new_ht.overflow_free;
+    ht_ptr->memory_size = new_ht.memory_size;
+    return true;
+}
+
+void htui32_compact_chaining_free(hash_table_uint32_t* ht_ptr)
+{
+    if (ht_ptr->slots_ptr != NULL) {
+        free_func(ht_ptr, ht_ptr->slots_ptr, ht_ptr->capacity * sizeof(hash_table_uint32_slot_t));
+    }
+    if (ht_ptr->overflow_ptr != NULL) {
+        free_func(ht_ptr, ht_ptr->overflow_ptr, ht_ptr->overflow_capacity * sizeof(hash_table_uint32_overflow_item_t));
+    }
+}
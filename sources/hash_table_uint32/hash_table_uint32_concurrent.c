@@ -0,0 +1,515 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "hash_table_uint32_concurrent.h"
+#include "hash_table_uint32_internal.h"
+#include "hash_table_uint32_sync.h"
+#include <string.h>
+
+/*
+ * Lock-striped concurrent table.
+ * Buckets hold pointers to the collision chains, every key is in an item of the item pool of its stripe.
+ * Resizing only relinks the items, so once the new bucket array is allocated it cannot fail,
+ * and the items never move to another stripe.
+ * Writers store the fields that lockless gets read with atomic stores, they are ordered by the sequence of the stripe.
+ */
+
+// Size of the padding that keeps the fields of neighbouring stripes on different cache lines
+#ifndef HTUI32_CACHE_LINE_SIZE
+#define HTUI32_CACHE_LINE_SIZE 64
+#endif
+
+// Number of the counters of lockless gets, threads over this number share the slots
+#ifndef HTUI32_CONCURRENT_READER_SLOTS
+#define HTUI32_CONCURRENT_READER_SLOTS 64
+#endif
+
+// Number of attempts of a lockless get after which it yields the processor to the writer of its stripe
+#ifndef HTUI32_CONCURRENT_SPINS_BEFORE_YIELD
+#define HTUI32_CONCURRENT_SPINS_BEFORE_YIELD 64
+#endif
+
+#define load_item(ptr) ((hash_table_uint32_item_t*)htui32_atomic_load_ptr((void* const*)(ptr)))
+#define store_item(ptr, item) htui32_atomic_store_ptr((void**)(ptr), (item))
+
+struct htui32_stripe {
+    // Protects all fields of the stripe and its buckets
+    htui32_rwlock_t lock;
+    // Bucket array the buckets of the stripe are in, during resizing it is the old array until the stripe is moved
+    hash_table_uint32_item_t** memory_ptr;
+    // Number of buckets in memory_ptr
+    size_t capacity;
+    // Odd while a writer changes the stripe, lockless gets retry if it is odd or changed during the get
+    size_t sequence;
+    // Number of keys in the stripe, written under the lock and read without it when the table size is counted
+    size_t size;
+    // Collision chain items of the keys of the stripe
+    htui32_item_pool_t item_pool;
+    // The key 0 is stored in the stripe of its hash
+    bool zero_key_is_used;
+    uint32_t zero_key_value;
+    char padding[HTUI32_CACHE_LINE_SIZE];
+};
+
+struct htui32_reader_slot {
+    // Number of the lockless gets in progress, by the parity of the epoch in which they started
+    size_t readers_count[2];
+    char padding[HTUI32_CACHE_LINE_SIZE];
+};
+
+// Reader slot of the thread plus 1, 0 until the thread makes its first lockless get
+static HTUI32_THREAD_LOCAL size_t thread_reader_slot = 0;
+// Slots are given to the threads in turn
+static size_t next_reader_slot = 0;
+
+static inline htui32_stripe_t* get_stripe(htui32_concurrent_t* ht_ptr, uint32_t hash)
+{
+    return &ht_ptr->stripes_ptr[hash & (ht_ptr->stripes_count - 1)];
+}
+
+// Returns the link to the first item of the collision chain of the hash, the stripe must be locked
+static inline hash_table_uint32_item_t** get_bucket(htui32_stripe_t* stripe_ptr, uint32_t hash)
+{
+    return &stripe_ptr->memory_ptr[hash & (stripe_ptr->capacity - 1)];
+}
+
+/*
+ * Returns the link (the bucket or the next field of the previous item) to the item with the key
+ * or the link at the end of the collision chain if the key is not in the stripe, the stripe must be locked
+ */
+static hash_table_uint32_item_t** find_link(htui32_stripe_t* stripe_ptr, uint32_t key, uint32_t hash)
+{
+    hash_table_uint32_item_t** link = get_bucket(stripe_ptr, hash);
+    while (*link != NULL && (*link)->key != key) {
+        link = &(*link)->next;
+    }
+    return link;
+}
+
+// Makes the sequence of the stripe odd before a change, the stripe must be locked
+static inline void begin_write(htui32_stripe_t* stripe_ptr)
+{
+    htui32_atomic_store(&stripe_ptr->sequence, stripe_ptr->sequence + 1);
+    htui32_atomic_fence_release();
+}
+
+// Makes the sequence of the stripe even after a change
+static inline void end_write(htui32_stripe_t* stripe_ptr)
+{
+    htui32_atomic_store_release(&stripe_ptr->sequence, stripe_ptr->sequence + 1);
+}
+
+// Lockless gets that started before the sequence was read have not seen a change since then
+static inline bool sequence_is_valid(htui32_stripe_t* stripe_ptr, size_t sequence)
+{
+    htui32_atomic_fence_acquire();
+    return htui32_atomic_load(&stripe_ptr->sequence) == sequence;
+}
+
+/*
+ * Counts a lockless get in the slot of the thread, the get must not read the stripes before it
+ * Returns the counter to pass to exit_read
+ */
+static inline size_t* enter_read(htui32_concurrent_t* ht_ptr)
+{
+    size_t slot = thread_reader_slot;
+    if (slot == 0) {
+        slot = htui32_atomic_add(&next_reader_slot, 1) % HTUI32_CONCURRENT_READER_SLOTS + 1;
+        thread_reader_slot = slot;
+    }
+    size_t epoch = htui32_atomic_load_seq_cst(&ht_ptr->epoch);
+    while (true) {
+        size_t* readers_count_ptr = &ht_ptr->reader_slots_ptr[slot - 1].readers_count[epoch & 1];
+        // Sequentially consistent, so the stripe is read after the resizing sees the get
+        htui32_atomic_add(readers_count_ptr, 1);
+        // A resizing that changed the epoch before the get was counted does not wait for its parity,
+        // so the get is counted again by the new parity
+        size_t current_epoch = htui32_atomic_load_seq_cst(&ht_ptr->epoch);
+        if (((current_epoch ^ epoch) & 1) == 0) {
+            return readers_count_ptr;
+        }
+        htui32_atomic_add(readers_count_ptr, (size_t)-1);
+        epoch = current_epoch;
+    }
+}
+
+static inline void exit_read(size_t* readers_count_ptr)
+{
+    htui32_atomic_add(readers_count_ptr, (size_t)-1);
+}
+
+/*
+ * Waits until no lockless get can use the memory that is no longer referenced by the stripes
+ * The gets that start after the epoch change are counted by the other parity and see only the new memory,
+ * the gets of the old parity that started before are waited for.
+ */
+static void wait_for_readers(htui32_concurrent_t* ht_ptr)
+{
+    size_t old_parity = htui32_atomic_add(&ht_ptr->epoch, 1) & 1;
+    for (size_t i = 0; i < HTUI32_CONCURRENT_READER_SLOTS; ++i) {
+        // Sequentially consistent, so the counters are read after the epoch change that the gets check
+        while (htui32_atomic_load_seq_cst(&ht_ptr->reader_slots_ptr[i].readers_count[old_parity]) != 0) {
+            htui32_yield();
+        }
+    }
+}
+
+// Sum of the stripe sizes, the stripes are not locked
+static size_t total_size(htui32_concurrent_t* ht_ptr)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < ht_ptr->stripes_count; ++i) {
+        size += htui32_atomic_load(&ht_ptr->stripes_ptr[i].size);
+    }
+    return size;
+}
+
+// Load of the stripe relative to its share of the table capacity reaches load_fac percent
+static inline bool stripe_load_reaches(htui32_concurrent_t* ht_ptr, htui32_stripe_t* stripe_ptr, uint8_t load_fac)
+{
+    return (uint64_t)stripe_ptr->size * 100 * ht_ptr->stripes_count >= (uint64_t)stripe_ptr->capacity * load_fac;
+}
+
+/*
+ * Moves the table to a new bucket array with new_capacity buckets stripe by stripe, the resize lock must be held
+ * Every stripe is locked only while its own buckets are moved
+ */
+static void move_to_capacity(htui32_concurrent_t* ht_ptr, size_t new_capacity)
+{
+    size_t new_memory_size = new_capacity * sizeof(hash_table_uint32_item_t*);
+    hash_table_uint32_item_t** new_memory = ht_ptr->allocator.alloc(ht_ptr->allocator.context, new_memory_size);
+    if (new_memory == NULL) {
+        return;
+    }
+    memset(new_memory, 0, new_memory_size);
+    hash_table_uint32_item_t** old_memory = ht_ptr->memory_ptr;
+    size_t old_capacity = ht_ptr->capacity;
+    for (size_t s = 0; s < ht_ptr->stripes_count; ++s) {
+        htui32_stripe_t* stripe_ptr = &ht_ptr->stripes_ptr[s];
+        htui32_rwlock_write_lock(&stripe_ptr->lock);
+        begin_write(stripe_ptr);
+        // The buckets of the stripe are the positions equal to s modulo stripes_count in both arrays
+        for (size_t i = s; i < old_capacity; i += ht_ptr->stripes_count) {
+            hash_table_uint32_item_t* item = old_memory[i];
+            while (item != NULL) {
+                hash_table_uint32_item_t* next_item = item->next;
+                hash_table_uint32_item_t** bucket = &new_memory[htui32_hash(item->key) & (new_capacity - 1)];
+                store_item(&item->next, *bucket);
+                store_item(bucket, item);
+                item = next_item;
+            }
+        }
+        htui32_atomic_store_ptr_seq_cst((void**)&stripe_ptr->memory_ptr, new_memory);
+        htui32_atomic_store(&stripe_ptr->capacity, new_capacity);
+        end_write(stripe_ptr);
+        htui32_rwlock_write_unlock(&stripe_ptr->lock);
+    }
+    ht_ptr->memory_ptr = new_memory;
+    ht_ptr->capacity = new_capacity;
+    // Locked operations read the old array only under the lock of a stripe that is already moved,
+    // lockless gets may still be reading it
+    if (ht_ptr->read_mostly) {
+        wait_for_readers(ht_ptr);
+    }
+    ht_ptr->allocator.free(ht_ptr->allocator.context, old_memory, old_capacity * sizeof(hash_table_uint32_item_t*));
+}
+
+/*
+ * Grows or shrinks the table if its load is out of the limits
+ * observed_capacity is the stripe capacity seen by the caller, nothing is done if the table was resized since then.
+ * If another thread is resizing, the call returns at once.
+ */
+static void check_and_resize(htui32_concurrent_t* ht_ptr, size_t observed_capacity, bool grow)
+{
+    if (!htui32_rwlock_try_write_lock(&ht_ptr->resize_stripe_ptr->lock)) {
+        return;
+    }
+    size_t capacity = ht_ptr->capacity;
+    if (capacity == observed_capacity) {
+        uint64_t load = (uint64_t)total_size(ht_ptr) * 100;
+        if (grow && load >= (uint64_t)capacity * ht_ptr->load_fac_max) {
+            move_to_capacity(ht_ptr, capacity * 2);
+        }
+        else if (!grow && load <= (uint64_t)capacity * ht_ptr->load_fac_min && capacity / 2 >= ht_ptr->initial_capacity) {
+            move_to_capacity(ht_ptr, capacity / 2);
+        }
+    }
+    htui32_rwlock_write_unlock(&ht_ptr->resize_stripe_ptr->lock);
+}
+
+static size_t round_up_power_of_two(size_t value)
+{
+    size_t rounded = 1;
+    while (rounded < value) {
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+void htui32_concurrent_init(htui32_concurrent_t* ht_ptr, const htui32_concurrent_config_t* config_ptr)
+{
+    htui32_concurrent_config_t default_config;
+    memset(&default_config, 0, sizeof(default_config));
+    if (config_ptr == NULL) {
+        config_ptr = &default_config;
+    }
+    if (ht_ptr == NULL) {
+        return;
+    }
+    ht_ptr->stripes_ptr = NULL;
+    ht_ptr->reader_slots_ptr = NULL;
+    if (config_ptr->load_fac_max > 100) {
+        return;
+    }
+    // Setup default values
+    ht_ptr->stripes_count = round_up_power_of_two(config_ptr->stripes_count != 0 ? config_ptr->stripes_count : HTUI32_CONCURRENT_DEFAULT_STRIPES);
+    size_t capacity = round_up_power_of_two(config_ptr->capacity);
+    if (capacity < ht_ptr->stripes_count) {
+        capacity = ht_ptr->stripes_count;
+    }
+    ht_ptr->capacity = capacity;
+    ht_ptr->initial_capacity = capacity;
+    ht_ptr->load_fac_min = (config_ptr->load_fac_min != 0 ? config_ptr->load_fac_min : 25);
+    ht_ptr->load_fac_max = (config_ptr->load_fac_max != 0 ? config_ptr->load_fac_max : 75);
+    ht_ptr->read_mostly = config_ptr->read_mostly;
+    ht_ptr->epoch = 0;
+    ht_ptr->allocator = (config_ptr->allocator != NULL) ? *config_ptr->allocator : htui32_default_allocator;
+
+    // Alloc memory, the resize stripe is allocated right after the stripes
+    size_t stripes_size = (ht_ptr->stripes_count + 1) * sizeof(htui32_stripe_t);
+    htui32_stripe_t* stripes = ht_ptr->allocator.alloc(ht_ptr->allocator.context, stripes_size);
+    if (stripes == NULL) {
+        return;
+    }
+    size_t memory_size = capacity * sizeof(hash_table_uint32_item_t*);
+    ht_ptr->memory_ptr = ht_ptr->allocator.alloc(ht_ptr->allocator.context, memory_size);
+    if (ht_ptr->memory_ptr == NULL) {
+        ht_ptr->allocator.free(ht_ptr->allocator.context, stripes, stripes_size);
+        return;
+    }
+    if (ht_ptr->read_mostly) {
+        size_t reader_slots_size = HTUI32_CONCURRENT_READER_SLOTS * sizeof(htui32_reader_slot_t);
+        ht_ptr->reader_slots_ptr = ht_ptr->allocator.alloc(ht_ptr->allocator.context, reader_slots_size);
+        if (ht_ptr->reader_slots_ptr == NULL) {
+            ht_ptr->allocator.free(ht_ptr->allocator.context, ht_ptr->memory_ptr, memory_size);
+            ht_ptr->allocator.free(ht_ptr->allocator.context, stripes, stripes_size);
+            return;
+        }
+        memset(ht_ptr->reader_slots_ptr, 0, reader_slots_size);
+    }
+    memset(ht_ptr->memory_ptr, 0, memory_size);
+    memset(stripes, 0, stripes_size);
+    for (size_t i = 0; i <= ht_ptr->stripes_count; ++i) {
+        htui32_rwlock_init(&stripes[i].lock);
+        stripes[i].memory_ptr = ht_ptr->memory_ptr;
+        stripes[i].capacity = capacity;
+        htui32_pool_init(&stripes[i].item_pool);
+    }
+    ht_ptr->stripes_ptr = stripes;
+    ht_ptr->resize_stripe_ptr = &stripes[ht_ptr->stripes_count];
+}
+
+bool htui32_concurrent_put(htui32_concurrent_t* ht_ptr, uint32_t key, uint32_t value)
+{
+    if (ht_ptr == NULL || ht_ptr->stripes_ptr == NULL) {
+        return false;
+    }
+    uint32_t hash = htui32_hash(key);
+    htui32_stripe_t* stripe_ptr = get_stripe(ht_ptr, hash);
+    bool is_added = false;
+    bool is_put = true;
+    htui32_rwlock_write_lock(&stripe_ptr->lock);
+    begin_write(stripe_ptr);
+    if (key == 0) {
+        is_added = !stripe_ptr->zero_key_is_used;
+        htui32_atomic_store_bool(&stripe_ptr->zero_key_is_used, true);
+        htui32_atomic_store_u32(&stripe_ptr->zero_key_value, value);
+    }
+    else {
+        hash_table_uint32_item_t** link = find_link(stripe_ptr, key, hash);
+        if (*link != NULL) {
+            htui32_atomic_store_u32(&(*link)->value, value);
+        }
+        else {
+            hash_table_uint32_item_t* new_item = htui32_pool_take(&stripe_ptr->item_pool, &ht_ptr->allocator);
+            if (new_item != NULL) {
+                htui32_atomic_store_u32(&new_item->key, key);
+                htui32_atomic_store_u32(&new_item->value, value);
+                store_item(&new_item->next, NULL);
+                store_item(link, new_item);
+                is_added = true;
+            }
+            else {
+                is_put = false;
+            }
+        }
+    }
+    end_write(stripe_ptr);
+    bool need_grow = false;
+    size_t observed_capacity = stripe_ptr->capacity;
+    if (is_added) {
+        htui32_atomic_store(&stripe_ptr->size, stripe_ptr->size + 1);
+        // The whole table is checked only when the stripe is loaded over its share
+        need_grow = stripe_load_reaches(ht_ptr, stripe_ptr, ht_ptr->load_fac_max);
+    }
+    htui32_rwlock_write_unlock(&stripe_ptr->lock);
+    if (need_grow) {
+        check_and_resize(ht_ptr, observed_capacity, true);
+    }
+    return is_put;
+}
+
+/*
+ * Searches for the key in the stripe without locking it
+ * Returns true if the key is found, the result is taken only from a walk that no writer interfered with
+ */
+static bool lockless_get(htui32_concurrent_t* ht_ptr, htui32_stripe_t* stripe_ptr, uint32_t key, uint32_t hash, uint32_t* value_ptr)
+{
+    size_t* readers_count_ptr = enter_read(ht_ptr);
+    bool has_found = false;
+    for (size_t attempt = 1; ; ++attempt) {
+        // The writer may have been preempted in the stripe, do not spin for the rest of the time slice
+        if (attempt % HTUI32_CONCURRENT_SPINS_BEFORE_YIELD == 0) {
+            htui32_yield();
+        }
+        size_t sequence = htui32_atomic_load_acquire(&stripe_ptr->sequence);
+        if ((sequence & 1) != 0) {
+            continue;
+        }
+        has_found = false;
+        if (key == 0) {
+            has_found = htui32_atomic_load_bool(&stripe_ptr->zero_key_is_used);
+            *value_ptr = htui32_atomic_load_u32(&stripe_ptr->zero_key_value);
+        }
+        else {
+            hash_table_uint32_item_t** memory = htui32_atomic_load_ptr_seq_cst((void* const*)&stripe_ptr->memory_ptr);
+            size_t capacity = htui32_atomic_load(&stripe_ptr->capacity);
+            // The array and its capacity must be of the same resizing before the array is indexed
+            if (!sequence_is_valid(stripe_ptr, sequence)) {
+                continue;
+            }
+            hash_table_uint32_item_t* item = load_item(&memory[hash & (capacity - 1)]);
+            while (item != NULL) {
+                if (htui32_atomic_load_u32(&item->key) == key) {
+                    *value_ptr = htui32_atomic_load_u32(&item->value);
+                    has_found = true;
+                    break;
+                }
+                item = load_item(&item->next);
+                // Items can be moved to another chain under the walk, even in a loop, so the walk is checked at every step
+                if (!sequence_is_valid(stripe_ptr, sequence)) {
+                    break;
+                }
+            }
+        }
+        if (sequence_is_valid(stripe_ptr, sequence)) {
+            break;
+        }
+    }
+    exit_read(readers_count_ptr);
+    return has_found;
+}
+
+bool htui32_concurrent_get(htui32_concurrent_t* ht_ptr, uint32_t key, uint32_t* value_ptr)
+{
+    if (ht_ptr == NULL || ht_ptr->stripes_ptr == NULL) {
+        return false;
+    }
+    uint32_t hash = htui32_hash(key);
+    htui32_stripe_t* stripe_ptr = get_stripe(ht_ptr, hash);
+    bool has_found = false;
+    uint32_t value = 0;
+    if (ht_ptr->read_mostly) {
+        has_found = lockless_get(ht_ptr, stripe_ptr, key, hash, &value);
+        if (has_found && value_ptr != NULL) {
+            *value_ptr = value;
+        }
+        return has_found;
+    }
+    htui32_rwlock_read_lock(&stripe_ptr->lock);
+    if (key == 0) {
+        has_found = stripe_ptr->zero_key_is_used;
+        value = stripe_ptr->zero_key_value;
+    }
+    else {
+        hash_table_uint32_item_t* item = *get_bucket(stripe_ptr, hash);
+        while (item != NULL && item->key != key) {
+            item = item->next;
+        }
+        if (item != NULL) {
+            has_found = true;
+            value = item->value;
+        }
+    }
+    htui32_rwlock_read_unlock(&stripe_ptr->lock);
+    if (has_found && value_ptr != NULL) {
+        *value_ptr = value;
+    }
+    return has_found;
+}
+
+void htui32_concurrent_delete(htui32_concurrent_t* ht_ptr, uint32_t key)
+{
+    if (ht_ptr == NULL || ht_ptr->stripes_ptr == NULL) {
+        return;
+    }
+    uint32_t hash = htui32_hash(key);
+    htui32_stripe_t* stripe_ptr = get_stripe(ht_ptr, hash);
+    bool is_removed = false;
+    htui32_rwlock_write_lock(&stripe_ptr->lock);
+    begin_write(stripe_ptr);
+    if (key == 0) {
+        is_removed = stripe_ptr->zero_key_is_used;
+        htui32_atomic_store_bool(&stripe_ptr->zero_key_is_used, false);
+        htui32_atomic_store_u32(&stripe_ptr->zero_key_value, 0);
+    }
+    else {
+        hash_table_uint32_item_t** link = find_link(stripe_ptr, key, hash);
+        hash_table_uint32_item_t* item = *link;
+        if (item != NULL) {
+            store_item(link, item->next);
+            htui32_pool_release(&stripe_ptr->item_pool, item);
+            is_removed = true;
+        }
+    }
+    end_write(stripe_ptr);
+    bool need_shrink = false;
+    size_t observed_capacity = stripe_ptr->capacity;
+    if (is_removed) {
+        htui32_atomic_store(&stripe_ptr->size, stripe_ptr->size - 1);
+        need_shrink = !stripe_load_reaches(ht_ptr, stripe_ptr, ht_ptr->load_fac_min) && observed_capacity / 2 >= ht_ptr->initial_capacity;
+    }
+    htui32_rwlock_write_unlock(&stripe_ptr->lock);
+    if (need_shrink) {
+        check_and_resize(ht_ptr, observed_capacity, false);
+    }
+}
+
+size_t htui32_concurrent_size(htui32_concurrent_t* ht_ptr)
+{
+    if (ht_ptr == NULL || ht_ptr->stripes_ptr == NULL) {
+        return 0;
+    }
+    return total_size(ht_ptr);
+}
+
+void htui32_concurrent_destroy(htui32_concurrent_t* ht_ptr)
+{
+    if (ht_ptr == NULL || ht_ptr->stripes_ptr == NULL) {
+        return;
+    }
+    for (size_t i = 0; i <= ht_ptr->stripes_count; ++i) {
+        htui32_pool_free(&ht_ptr->stripes_ptr[i].item_pool, &ht_ptr->allocator);
+        htui32_rwlock_destroy(&ht_ptr->stripes_ptr[i].lock);
+    }
+    ht_ptr->allocator.free(ht_ptr->allocator.context, ht_ptr->memory_ptr, ht_ptr->capacity * sizeof(hash_table_uint32_item_t*));
+    ht_ptr->allocator.free(ht_ptr->allocator.context, ht_ptr->stripes_ptr, (ht_ptr->stripes_count + 1) * sizeof(htui32_stripe_t));
+    if (ht_ptr->reader_slots_ptr != NULL) {
+        ht_ptr->allocator.free(ht_ptr->allocator.context, ht_ptr->reader_slots_ptr, HTUI32_CONCURRENT_READER_SLOTS * sizeof(htui32_reader_slot_t));
+    }
+    ht_ptr->stripes_ptr = NULL;
+    ht_ptr->reader_slots_ptr = NULL;
+    ht_ptr->resize_stripe_ptr = NULL;
+    ht_ptr->memory_ptr = NULL;
+    ht_ptr->capacity = 0;
+}
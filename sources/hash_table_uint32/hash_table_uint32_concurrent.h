@@ -0,0 +1,132 @@
+#ifndef _HASH_TABLE_UINT32_CONCURRENT_
+#define _HASH_TABLE_UINT32_CONCURRENT_
+
+/*
+ * Concurrent hash table for keys and values of uint32_t type with separate chaining.
+ * Put, get, delete and size can be called from any number of threads at once, init and destroy cannot.
+ *
+ * Buckets are split between lock stripes: the stripe of a bucket is its position modulo the number of stripes.
+ * Operations on different stripes do not wait for each other, gets of the same stripe share its lock.
+ * The capacity is a power of two and a multiple of the number of stripes, so a key stays in its stripe after resizing.
+ * Resizing moves the table to the new bucket array stripe by stripe,
+ * so an operation waits only while its own stripe is being moved, not for the whole rehash.
+ *
+ * In the read-mostly mode gets take no locks at all. Every stripe has a sequence counter that puts, deletes
+ * and resizing make odd while they change the stripe, a get that sees it odd or changed is retried.
+ * Collision chain items are never freed before destroy, and an old bucket array is freed only after
+ * every get that could have seen it has finished, so lockless gets never read freed memory.
+ */
+
+#include "hash_table_uint32.h"
+
+// Lock stripe of the concurrent table, defined in hash_table_uint32_concurrent.c
+typedef struct htui32_stripe htui32_stripe_t;
+
+// Counters of the gets in progress in the read-mostly mode, defined in hash_table_uint32_concurrent.c
+typedef struct htui32_reader_slot htui32_reader_slot_t;
+
+// Number of lock stripes used when 0 is requested, can be overridden at compile time
+#ifndef HTUI32_CONCURRENT_DEFAULT_STRIPES
+#define HTUI32_CONCURRENT_DEFAULT_STRIPES 64
+#endif
+
+typedef struct {
+    // Lock stripes, each stripe also keeps the bucket array its buckets are in
+    htui32_stripe_t* stripes_ptr;
+    // Number of lock stripes, a power of two
+    size_t stripes_count;
+    // Stripe used only for its lock, it serializes resizing
+    htui32_stripe_t* resize_stripe_ptr;
+
+    // Total table capacity (the fields below are changed only under the resize lock)
+    size_t capacity;
+    // The hash table will not shrink to less than this size
+    size_t initial_capacity;
+    // Bucket array, a bucket is the first item of its collision chain
+    hash_table_uint32_item_t** memory_ptr;
+    // Percentage of hash table load at reaching which its capacity will be increased
+    uint8_t load_fac_max;
+    // Percentage of hash table load at reaching which its capacity will be reduced
+    uint8_t load_fac_min;
+
+    // Gets take no locks
+    bool read_mostly;
+    // Counters of the lockless gets in progress, a thread always uses the same slot (NULL if read_mostly is false)
+    htui32_reader_slot_t* reader_slots_ptr;
+    // Incremented by every resizing in the read-mostly mode, a get is counted by the parity of the epoch it started in
+    size_t epoch;
+
+    // Memory allocator, it must be thread-safe
+    htui32_allocator_t allocator;
+} htui32_concurrent_t;
+
+// Table parameters for htui32_concurrent_init, zero in any field means the default value
+typedef struct {
+    // Initial total size of the hash table, rounded up to a power of two of at least stripes_count
+    size_t capacity;
+    // Percentage of the hash table load, at which its size will decrease and rehashing will be performed
+    uint8_t load_fac_min;
+    // Percentage of the hash table load, at which its size will increase and rehashing will be performed
+    uint8_t load_fac_max;
+    // Number of lock stripes, rounded up to a power of two (HTUI32_CONCURRENT_DEFAULT_STRIPES by default)
+    size_t stripes_count;
+    // Gets take no locks, puts and deletes still lock their stripe, resizing waits for the gets that may use the old buckets
+    bool read_mostly;
+    // Memory allocator, it is copied to the table and must be thread-safe (NULL for malloc and free)
+    const htui32_allocator_t* allocator;
+} htui32_concurrent_config_t;
+
+/*
+ * Initializes the table
+ * The table stays unusable (stripes_ptr is NULL) if the memory could not be allocated, the other functions do nothing in this case
+ *
+ * ht_ptr - pointer to hash table
+ * config_ptr - table parameters (NULL for the default values)
+ */
+extern void htui32_concurrent_init(htui32_concurrent_t* ht_ptr, const htui32_concurrent_config_t* config_ptr);
+
+/*
+ * Puts value by key
+ * Returns false if the key is new and could not be put because the memory could not be allocated
+ *
+ * ht_ptr - pointer to hash table
+ * key - key
+ * value - value
+ */
+extern bool htui32_concurrent_put(htui32_concurrent_t* ht_ptr, uint32_t key, uint32_t value);
+
+/*
+ * Gets value by key
+ *
+ * ht_ptr - pointer to hash table
+ * key - key
+ * value_ptr - pointer to the variable in which the value will be written (can be NULL)
+ *
+ * Returns true if the key is found, otherwise false
+ */
+extern bool htui32_concurrent_get(htui32_concurrent_t* ht_ptr, uint32_t key, uint32_t* value_ptr);
+
+/*
+ * Deletes value by key
+ *
+ * ht_ptr - pointer to hash table
+ * key - key
+ */
+extern void htui32_concurrent_delete(htui32_concurrent_t* ht_ptr, uint32_t key);
+
+/*
+ * Returns the number of keys in the table
+ * The stripes are counted one after another, so with concurrent puts and deletes the result is approximate
+ *
+ * ht_ptr - pointer to hash table
+ */
+extern size_t htui32_concurrent_size(htui32_concurrent_t* ht_ptr);
+
+/*
+ * Frees the table memory, no other function may be running on the table
+ *
+ * ht_ptr - pointer to hash table
+ */
+extern void htui32_concurrent_destroy(htui32_concurrent_t* ht_ptr);
+
+#endif
@@ -0,0 +1,242 @@
+#include "hash_table_uint32_internal.h"
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Bucketized cuckoo mode of the hash table.
+ * Slots are split into buckets of HTUI32_CUCKOO_BUCKET_SLOTS, the buckets are aligned to their size,
+ * so an 8-slot bucket is exactly one 64-byte cache line. A key is in one of its two buckets, which are selected
+ * by two hashes of the key, so a lookup reads at most two buckets and there are no chains or probe sequences.
+ * The key 0 marks an empty slot (the key 0 itself is stored in zero_key_value).
+ * When both buckets of a new key are full, a key of one of them is moved to its other bucket, and so on
+ * (a cuckoo walk of at most CUCKOO_MAX_KICKS moves), if the walk fails it is undone and the table grows.
+ */
+
+#define BUCKET_SLOTS HTUI32_CUCKOO_BUCKET_SLOTS
+
+// Maximum number of keys moved to place one new key
+#define CUCKOO_MAX_KICKS 128
+
+// Number of times the table grows for a key that does not fit before the put fails
+#define CUCKOO_MAX_GROWTHS 2
+
+static inline size_t buckets_count(const hash_table_uint32_t* ht_ptr)
+{
+    return ht_ptr->capacity / BUCKET_SLOTS;
+}
+
+static inline size_t first_bucket(const hash_table_uint32_t* ht_ptr, uint32_t hash)
+{
+    return hash & (buckets_count(ht_ptr) - 1);
+}
+
+// The second hash is the finalizer applied to the first one with another seed, so it is independent of the first bucket
+static inline size_t second_bucket(const hash_table_uint32_t* ht_ptr, uint32_t hash)
+{
+    return htui32_hash_fmix32(hash ^ 0x9e3779b9) & (buckets_count(ht_ptr) - 1);
+}
+
+static inline hash_table_uint32_slot_t* bucket_slots(hash_table_uint32_t* ht_ptr, size_t bucket)
+{
+    return &ht_ptr->slots_ptr[bucket * BUCKET_SLOTS];
+}
+
+// Returns the slot of the key in the bucket or NULL
+static inline hash_table_uint32_slot_t* bucket_find(hash_table_uint32_t* ht_ptr, size_t bucket, uint32_t key)
+{
+    hash_table_uint32_slot_t* slots = bucket_slots(ht_ptr, bucket);
+    HTUI32_COUNT(ht_ptr, probe_steps_count, 1);
+    for (size_t i = 0; i < BUCKET_SLOTS; ++i) {
+        if (slots[i].key == key) {
+            return &slots[i];
+        }
+    }
+    return NULL;
+}
+
+// Returns the first free slot of the bucket or NULL
+static inline hash_table_uint32_slot_t* bucket_free_slot(hash_table_uint32_t* ht_ptr, size_t bucket)
+{
+    return bucket_find(ht_ptr, bucket, 0);
+}
+
+/*
+ * Moves keys to their other buckets until one of them gets to a free slot, the new key takes the slot of the first moved key
+ * The walk is recorded and undone if it takes more than CUCKOO_MAX_KICKS moves, the table is unchanged then
+ * Returns false if the walk failed
+ */
+static bool cuckoo_walk(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value)
+{
+    size_t path[CUCKOO_MAX_KICKS];
+    hash_table_uint32_slot_t in_hand;
+    in_hand.key = key;
+    in_hand.value = value;
+    uint32_t in_hand_hash = hash;
+    size_t bucket = first_bucket(ht_ptr, hash);
+    for (size_t kick = 0; kick < CUCKOO_MAX_KICKS; ++kick) {
+        // The victim depends on the key and the move, so a walk does not bounce between the same two keys
+        size_t pos = bucket * BUCKET_SLOTS + (((in_hand_hash >> 16) + kick) & (BUCKET_SLOTS - 1));
+        path[kick] = pos;
+        hash_table_uint32_slot_t victim = ht_ptr->slots_ptr[pos];
+        ht_ptr->slots_ptr[pos] = in_hand;
+        in_hand = victim;
+        in_hand_hash = htui32_hash(in_hand.key);
+        size_t victim_bucket = first_bucket(ht_ptr, in_hand_hash);
+        bucket = (victim_bucket != bucket) ? victim_bucket : second_bucket(ht_ptr, in_hand_hash);
+        hash_table_uint32_slot_t* free_slot = bucket_free_slot(ht_ptr, bucket);
+        if (free_slot != NULL) {
+            *free_slot = in_hand;
+            return true;
+        }
+    }
+    for (size_t kick = CUCKOO_MAX_KICKS; kick-- > 0;) {
+        hash_table_uint32_slot_t moved = ht_ptr->slots_ptr[path[kick]];
+        ht_ptr->slots_ptr[path[kick]] = in_hand;
+        in_hand = moved;
+    }
+    return false;
+}
+
+// Puts a new key to a free slot of its buckets or by a cuckoo walk, returns its slot or NULL if it does not fit
+static hash_table_uint32_slot_t* place_key(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value)
+{
+    hash_table_uint32_slot_t* slot = bucket_free_slot(ht_ptr, first_bucket(ht_ptr, hash));
+    if (slot == NULL) {
+        slot = bucket_free_slot(ht_ptr, second_bucket(ht_ptr, hash));
+    }
+    if (slot != NULL) {
+        slot->key = key;
+        slot->value = value;
+        return slot;
+    }
+    if (!cuckoo_walk(ht_ptr, key, hash, value)) {
+        return NULL;
+    }
+    // The new key could be moved again by the walk
+    slot = bucket_find(ht_ptr, first_bucket(ht_ptr, hash), key);
+    return (slot != NULL) ? slot : bucket_find(ht_ptr, second_bucket(ht_ptr, hash), key);
+}
+
+/*
+ * Same as place_key, but a key that does not fit grows the table (even below load_fac_max) and is placed again
+ * Returns NULL if it does not fit after CUCKOO_MAX_GROWTHS growths or the memory could not be allocated
+ */
+static hash_table_uint32_slot_t* insert_key(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value)
+{
+    for (size_t growth = 0; ; ++growth) {
+        hash_table_uint32_slot_t* slot = place_key(ht_ptr, key, hash, value);
+        if (slot != NULL || growth == CUCKOO_MAX_GROWTHS) {
+            return slot;
+        }
+        uint64_t start_ns = htui32_stats_now_ns();
+        bool is_rehashed = htui32_cuckoo_rehash(ht_ptr, ht_ptr->capacity * 2);
+        HTUI32_COUNT(ht_ptr, rehash_time_ns, htui32_stats_now_ns() - start_ns);
+        if (!is_rehashed) {
+            return NULL;
+        }
+        HTUI32_COUNT(ht_ptr, grow_count, 1);
+    }
+}
+
+size_t htui32_cuckoo_round_capacity(size_t capacity)
+{
+    size_t rounded = BUCKET_SLOTS;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+uint32_t* htui32_cuckoo_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    HTUI32_COUNT(ht_ptr, lookups_count, 1);
+    hash_table_uint32_slot_t* slot = bucket_find(ht_ptr, first_bucket(ht_ptr, hash), key);
+    if (slot == NULL) {
+        slot = bucket_find(ht_ptr, second_bucket(ht_ptr, hash), key);
+    }
+    return (slot != NULL) ? &slot->value : NULL;
+}
+
+bool htui32_cuckoo_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value)
+{
+    return insert_key(ht_ptr, key, hash, value) != NULL;
+}
+
+uint32_t* htui32_cuckoo_find_or_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, bool* is_inserted_ptr)
+{
+    uint32_t* value_ptr = htui32_cuckoo_find(ht_ptr, key, hash);
+    if (value_ptr != NULL) {
+        return value_ptr;
+    }
+    hash_table_uint32_slot_t* slot = insert_key(ht_ptr, key, hash, value);
+    if (slot == NULL) {
+        return NULL;
+    }
+    *is_inserted_ptr = true;
+    return &slot->value;
+}
+
+bool htui32_cuckoo_remove(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    uint32_t* value_ptr = htui32_cuckoo_find(ht_ptr, key, hash);
+    if (value_ptr == NULL) {
+        return false;
+    }
+    // The value follows the key in the slot
+    hash_table_uint32_slot_t* slot = (hash_table_uint32_slot_t*)((char*)value_ptr - offsetof(hash_table_uint32_slot_t, value));
+    slot->key = 0;
+    slot->value = 0;
+    return true;
+}
+
+size_t htui32_cuckoo_probe_length(hash_table_uint32_t* ht_ptr, size_t pos)
+{
+    return (pos / BUCKET_SLOTS == first_bucket(ht_ptr, htui32_hash(ht_ptr->slots_ptr[pos].key))) ? 1 : 2;
+}
+
+void htui32_cuckoo_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash)
+{
+    htui32_prefetch(bucket_slots(ht_ptr, first_bucket(ht_ptr, hash)));
+    htui32_prefetch(bucket_slots(ht_ptr, second_bucket(ht_ptr, hash)));
+}
+
+bool htui32_cuckoo_rehash(hash_table_uint32_t* ht_ptr, size_t new_capacity)
+{
+    new_capacity = htui32_cuckoo_round_capacity(new_capacity);
+    size_t used_slots = ht_ptr->size - (ht_ptr->zero_key_is_used ? 1 : 0);
+    if (used_slots > new_capacity) {
+        return false;
+    }
+    // The slots are aligned to the bucket size within the allocation
+    size_t bucket_size = BUCKET_SLOTS * sizeof(hash_table_uint32_slot_t);
+    size_t new_memory_size = new_capacity * sizeof(hash_table_uint32_slot_t) + bucket_size - 1;
+    void* new_memory = alloc_func(ht_ptr, new_memory_size);
+    if (new_memory == NULL) {
+        return false;
+    }
+    // The new table is set up in a copy, so the old one stays intact if its keys do not fit
+    hash_table_uint32_t new_ht = *ht_ptr;
+    new_ht.slots_ptr = (hash_table_uint32_slot_t*)(((uintptr_t)new_memory + bucket_size - 1) & ~(uintptr_t)(bucket_size - 1));
+    new_ht.capacity = new_capacity;
+    memset(new_ht.slots_ptr, 0, new_capacity * sizeof(hash_table_uint32_slot_t));
+    for (size_t i = 0; i < ht_ptr->capacity; ++i) {
+        uint32_t key = ht_ptr->slots_ptr[i].key;
+        if (key != 0 && place_key(&new_ht, key, htui32_hash(key), ht_ptr->slots_ptr[i].value) == NULL) {
+            free_func(ht_ptr, new_memory, new_memory_size);
+            return false;
+        }
+    }
+    htui32_cuckoo_free(ht_ptr);
+    ht_ptr->cuckoo_memory_ptr = new_memory;
+    ht_ptr->slots_ptr = new_ht.slots_ptr;
+    ht_ptr->capacity = new_capacity;
+    ht_ptr->memory_size = new_memory_size;
+    return true;
+}
+
+void htui32_cuckoo_free(hash_table_uint32_t* ht_ptr)
+{
+    if (ht_ptr->cuckoo_memory_ptr != NULL) {
+        free_func(ht_ptr, ht_ptr->cuckoo_memory_ptr, ht_ptr->memory_size);
+    }
+}
@@ -0,0 +1,267 @@
+#include "hash_table_uint32_internal.h"
+#include <string.h>
+
+/*
+ * Frozen mode of the hash table: a read-only table on a minimal perfect hash built the PTHash way.
+ * The keys are split into buckets by their hash, and every bucket gets a 16-bit pilot, such that the hash of a key
+ * mixed with the pilot of its bucket gives a slot no other key has. The buckets are placed from the biggest one,
+ * while most of the slots are still free, and the pilot of a bucket is the first one that finds free slots for all its keys.
+ * The slots are 1% more than the keys, so the single-key buckets placed last still find a free slot in a few tries.
+ */
+
+// Average number of keys in a bucket, that is 4 bits of pilot per key
+#define FROZEN_BUCKET_SIZE 4
+// Percentage of the slots over the number of keys
+#define FROZEN_SPARE_SLOTS 1
+// The build starts over with another seed if a bucket gets no pilot, the later attempts have more spare slots
+#define FROZEN_MAX_ATTEMPTS 8
+// 60% of the hashes (0.6 * 2^32) go to the dense buckets, 30% of all buckets, so the buckets differ in size
+#define FROZEN_DENSE_HASH_LIMIT 0x9999999Au
+
+static inline uint32_t frozen_hash(const hash_table_uint32_t* ht_ptr, uint32_t hash)
+{
+    return htui32_hash_fmix32(hash ^ ht_ptr->frozen_seed);
+}
+
+static inline size_t frozen_bucket(const hash_table_uint32_t* ht_ptr, uint32_t frozen_hash)
+{
+    // The product by an odd number spreads the hashes below the limit over all 32 bits again
+    uint64_t remixed_hash = frozen_hash * 0x9e3779b1u;
+    if (frozen_hash < FROZEN_DENSE_HASH_LIMIT) {
+        return (size_t)((remixed_hash * ht_ptr->dense_pilots_count) >> 32);
+    }
+    return ht_ptr->dense_pilots_count + (size_t)((remixed_hash * (ht_ptr->pilots_count - ht_ptr->dense_pilots_count)) >> 32);
+}
+
+static inline size_t frozen_position(const hash_table_uint32_t* ht_ptr, uint32_t frozen_hash, uint16_t pilot)
+{
+    uint32_t position_hash = htui32_hash_fmix32(frozen_hash ^ (pilot * 0x9e3779b1u));
+    return (size_t)(((uint64_t)position_hash * ht_ptr->capacity) >> 32);
+}
+
+uint32_t* htui32_frozen_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    HTUI32_COUNT(ht_ptr, lookups_count, 1);
+    HTUI32_COUNT(ht_ptr, probe_steps_count, 1);
+    uint32_t key_hash = frozen_hash(ht_ptr, hash);
+    hash_table_uint32_slot_t* slot = &ht_ptr->slots_ptr[frozen_position(ht_ptr, key_hash, ht_ptr->pilots_ptr[frozen_bucket(ht_ptr, key_hash)])];
+    return (slot->key == key) ? &slot->value : NULL;
+}
+
+void htui32_frozen_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash)
+{
+    htui32_prefetch(&ht_ptr->pilots_ptr[frozen_bucket(ht_ptr, frozen_hash(ht_ptr, hash))]);
+}
+
+bool htui32_frozen_get(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t* value_ptr)
+{
+    if (ht_ptr == NULL || ht_ptr->mode != HTUI32_MODE_FROZEN) {
+        return false;
+    }
+    if (key == 0) {
+        if (ht_ptr->zero_key_is_used && value_ptr != NULL) {
+            *value_ptr = ht_ptr->zero_key_value;
+        }
+        return ht_ptr->zero_key_is_used;
+    }
+    uint32_t* item_value_ptr = htui32_frozen_find(ht_ptr, key, htui32_hash(key));
+    if (item_value_ptr == NULL) {
+        return false;
+    }
+    if (value_ptr != NULL) {
+        *value_ptr = *item_value_ptr;
+    }
+    return true;
+}
+
+typedef struct {
+    // Keys and values of the table, and the frozen hashes of the keys
+    hash_table_uint32_slot_t* items;
+    uint32_t* hashes;
+    size_t count;
+    // Item indexes ordered by bucket, the items of the bucket i start at bucket_starts[i]
+    uint32_t* ordered_items;
+    uint32_t* bucket_starts;
+    // Buckets ordered by size, the biggest first
+    uint32_t* ordered_buckets;
+    // Bitmap of the taken slots
+    uint64_t* taken_slots;
+    // Slots of the bucket being placed
+    size_t* positions;
+} frozen_builder_t;
+
+static void collect_item(void* context, uint32_t key, uint32_t value)
+{
+    frozen_builder_t* builder = context;
+    builder->items[builder->count].key = key;
+    builder->items[builder->count].value = value;
+    builder->count++;
+}
+
+// Tries to find the pilots of all buckets, the frozen table (capacity, pilots and seed) must be set up in ht_ptr
+static bool place_buckets(hash_table_uint32_t* ht_ptr, frozen_builder_t* builder)
+{
+    size_t pilots_count = ht_ptr->pilots_count;
+    memset(builder->bucket_starts, 0, (pilots_count + 1) * sizeof(uint32_t));
+    memset(builder->taken_slots, 0, (ht_ptr->capacity / 64 + 1) * sizeof(uint64_t));
+
+    // Counting sort of the items by bucket
+    for (size_t i = 0; i < builder->count; ++i) {
+        builder->hashes[i] = frozen_hash(ht_ptr, htui32_hash(builder->items[i].key));
+        builder->bucket_starts[frozen_bucket(ht_ptr, builder->hashes[i]) + 1]++;
+    }
+    size_t max_bucket_size = 0;
+    for (size_t i = 0; i < pilots_count; ++i) {
+        if (builder->bucket_starts[i + 1] > max_bucket_size) {
+            max_bucket_size = builder->bucket_starts[i + 1];
+        }
+        builder->bucket_starts[i + 1] += builder->bucket_starts[i];
+    }
+    // The ordered buckets are used as the fill positions of the buckets for a while
+    memcpy(builder->ordered_buckets, builder->bucket_starts, pilots_count * sizeof(uint32_t));
+    for (size_t i = 0; i < builder->count; ++i) {
+        builder->ordered_items[builder->ordered_buckets[frozen_bucket(ht_ptr, builder->hashes[i])]++] = (uint32_t)i;
+    }
+    // Positions hold the counters of the bucket sizes for a while, it has room for every size from 0 to the biggest one
+    memset(builder->positions, 0, (max_bucket_size + 1) * sizeof(size_t));
+    for (size_t i = 0; i < pilots_count; ++i) {
+        builder->positions[max_bucket_size - (builder->bucket_starts[i + 1] - builder->bucket_starts[i])]++;
+    }
+    size_t start = 0;
+    for (size_t i = 0; i <= max_bucket_size; ++i) {
+        size_t count = builder->positions[i];
+        builder->positions[i] = start;
+        start += count;
+    }
+    for (size_t i = 0; i < pilots_count; ++i) {
+        builder->ordered_buckets[builder->positions[max_bucket_size - (builder->bucket_starts[i + 1] - builder->bucket_starts[i])]++] = (uint32_t)i;
+    }
+
+    for (size_t b = 0; b < pilots_count; ++b) {
+        uint32_t bucket = builder->ordered_buckets[b];
+        const uint32_t* bucket_items = &builder->ordered_items[builder->bucket_starts[bucket]];
+        size_t bucket_size = builder->bucket_starts[bucket + 1] - builder->bucket_starts[bucket];
+        if (bucket_size == 0) {
+            // The rest of the buckets are empty too, their pilots stay 0
+            break;
+        }
+        uint32_t pilot = 0;
+        for (; pilot <= UINT16_MAX; ++pilot) {
+            size_t placed_count = 0;
+            for (; placed_count < bucket_size; ++placed_count) {
+                size_t position = frozen_position(ht_ptr, builder->hashes[bucket_items[placed_count]], (uint16_t)pilot);
+                if (builder->taken_slots[position / 64] & ((uint64_t)1 << (position % 64))) {
+                    break;
+                }
+                // Keys of the same bucket must not take the same slot either
+                builder->taken_slots[position / 64] |= (uint64_t)1 << (position % 64);
+                builder->positions[placed_count] = position;
+            }
+            if (placed_count == bucket_size) {
+                break;
+            }
+            for (size_t i = 0; i < placed_count; ++i) {
+                builder->taken_slots[builder->positions[i] / 64] &= ~((uint64_t)1 << (builder->positions[i] % 64));
+            }
+        }
+        if (pilot > UINT16_MAX) {
+            return false;
+        }
+        ht_ptr->pilots_ptr[bucket] = (uint16_t)pilot;
+        for (size_t i = 0; i < bucket_size; ++i) {
+            ht_ptr->slots_ptr[builder->positions[i]] = builder->items[bucket_items[i]];
+        }
+    }
+    return true;
+}
+
+bool htui32_freeze(hash_table_uint32_t* ht_ptr)
+{
+    if (ht_ptr == NULL || ht_ptr->capacity == 0) {
+        return false;
+    }
+    if (ht_ptr->mode == HTUI32_MODE_FROZEN) {
+        return true;
+    }
+    // The frozen table is allocated, while the caller's buffer must not be replaced
+    if (ht_ptr->fixed_buffer) {
+        return false;
+    }
+    size_t count = ht_ptr->size - (ht_ptr->zero_key_is_used ? 1 : 0);
+    // Item indexes and bucket starts are 32-bit
+    if (count > UINT32_MAX / 2) {
+        return false;
+    }
+    // At least two buckets, so that there are dense and sparse ones
+    size_t pilots_count = count / FROZEN_BUCKET_SIZE + 2;
+    size_t max_capacity = count + count * FROZEN_SPARE_SLOTS * FROZEN_MAX_ATTEMPTS / 100 + 1;
+
+    // The frozen table is set up in a copy, the table stays usable until the build succeeds
+    hash_table_uint32_t frozen = *ht_ptr;
+    frozen.pilots_count = pilots_count;
+    frozen.dense_pilots_count = pilots_count * 3 / 10 + 1;
+
+    frozen_builder_t builder;
+    memset(&builder, 0, sizeof(builder));
+    size_t items_size = (count + 1) * sizeof(hash_table_uint32_slot_t);
+    size_t hashes_size = (count + 1) * sizeof(uint32_t);
+    size_t ordered_items_size = (count + 1) * sizeof(uint32_t);
+    size_t bucket_starts_size = (pilots_count + 1) * sizeof(uint32_t);
+    size_t ordered_buckets_size = pilots_count * sizeof(uint32_t);
+    size_t taken_slots_size = (max_capacity / 64 + 1) * sizeof(uint64_t);
+    size_t positions_size = (count + 1) * sizeof(size_t);
+    size_t build_memory_size = items_size + hashes_size + ordered_items_size + bucket_starts_size + ordered_buckets_size + taken_slots_size + positions_size;
+    // The 8-byte aligned arrays go first
+    char* build_memory = alloc_func(ht_ptr, build_memory_size);
+    if (build_memory == NULL) {
+        return false;
+    }
+    builder.items = (hash_table_uint32_slot_t*)build_memory;
+    builder.positions = (size_t*)(build_memory + items_size);
+    builder.taken_slots = (uint64_t*)((char*)builder.positions + positions_size);
+    builder.hashes = (uint32_t*)((char*)builder.taken_slots + taken_slots_size);
+    builder.ordered_items = (uint32_t*)((char*)builder.hashes + hashes_size);
+    builder.bucket_starts = (uint32_t*)((char*)builder.ordered_items + ordered_items_size);
+    builder.ordered_buckets = (uint32_t*)((char*)builder.bucket_starts + bucket_starts_size);
+    htui32_visit_items(ht_ptr, collect_item, &builder);
+
+    bool is_built = false;
+    size_t memory_size = 0;
+    for (uint32_t attempt = 0; attempt < FROZEN_MAX_ATTEMPTS && !is_built; ++attempt) {
+        frozen.capacity = count + count * FROZEN_SPARE_SLOTS * (attempt + 1) / 100 + 1;
+        frozen.frozen_seed = htui32_hash_fmix32(attempt + 1);
+        memory_size = frozen.capacity * sizeof(hash_table_uint32_slot_t) + pilots_count * sizeof(uint16_t);
+        frozen.slots_ptr = alloc_func(ht_ptr, memory_size);
+        if (frozen.slots_ptr == NULL) {
+            break;
+        }
+        memset(frozen.slots_ptr, 0, memory_size);
+        frozen.pilots_ptr = (uint16_t*)(frozen.slots_ptr + frozen.capacity);
+        is_built = place_buckets(&frozen, &builder);
+        if (!is_built) {
+            free_func(ht_ptr, frozen.slots_ptr, memory_size);
+        }
+    }
+    free_func(ht_ptr, build_memory, build_memory_size);
+    if (!is_built) {
+        return false;
+    }
+
+    htui32_destroy(ht_ptr);
+    ht_ptr->mode = HTUI32_MODE_FROZEN;
+    ht_ptr->capacity = frozen.capacity;
+    ht_ptr->initial_capacity = frozen.capacity;
+    ht_ptr->memory_ptr = NULL;
+    ht_ptr->slots_ptr = frozen.slots_ptr;
+    ht_ptr->ctrl_ptr = NULL;
+    ht_ptr->deleted_count = 0;
+    ht_ptr->old_memory_ptr = NULL;
+    ht_ptr->old_capacity = 0;
+    ht_ptr->rehash_pos = 0;
+    ht_ptr->memory_size = memory_size;
+    ht_ptr->pilots_ptr = frozen.pilots_ptr;
+    ht_ptr->pilots_count = frozen.pilots_count;
+    ht_ptr->dense_pilots_count = frozen.dense_pilots_count;
+    ht_ptr->frozen_seed = frozen.frozen_seed;
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef _HASH_TABLE_UINT32_HASH_
+#define _HASH_TABLE_UINT32_HASH_
+
+/*
+ * Hash functions of the hash table for a single uint32_t key.
+ * The table uses htui32_hash, the function is selected at compile time with HTUI32_HASH.
+ */
+
+#include <stdint.h>
+#include "murmur_hash3/murmur_hash3.h"
+
+// Generic MurmurHash3_x86_32 call with seed 0
+#define HTUI32_HASH_MURMUR3 1
+// MurmurHash3 finalizer, the same avalanche quality for a 4-byte key without the block loop, tail and out-parameter
+#define HTUI32_HASH_FMIX32 2
+// Multiplication by the golden ratio with the high half folded into the low bits, the cheapest one
+#define HTUI32_HASH_MULTIPLY_SHIFT 3
+
+#ifndef HTUI32_HASH
+#define HTUI32_HASH HTUI32_HASH_FMIX32
+#endif
+
+static inline uint32_t htui32_hash_murmur3(uint32_t key)
+{
+    uint32_t hash = 0;
+    MurmurHash3_x86_32(&key, sizeof(key), 0, &hash);
+    return hash;
+}
+
+static inline uint32_t htui32_hash_fmix32(uint32_t key)
+{
+    key ^= key >> 16;
+    key *= 0x85ebca6b;
+    key ^= key >> 13;
+    key *= 0xc2b2ae35;
+    key ^= key >> 16;
+    return key;
+}
+
+static inline uint32_t htui32_hash_multiply_shift(uint32_t key)
+{
+    // The product has good high bits only, buckets are selected by the low bits
+    uint32_t hash = key * 0x9e3779b1;
+    return hash ^ (hash >> 16);
+}
+
+static inline uint32_t htui32_hash(uint32_t key)
+{
+#if HTUI32_HASH == HTUI32_HASH_MURMUR3
+    return htui32_hash_murmur3(key);
+#elif HTUI32_HASH == HTUI32_HASH_MULTIPLY_SHIFT
+    return htui32_hash_multiply_shift(key);
+#else
+    return htui32_hash_fmix32(key);
+#endif
+}
+
+#endif
@@ -0,0 +1,280 @@
+#ifndef _HASH_TABLE_UINT32_INTERNAL_
+#define _HASH_TABLE_UINT32_INTERNAL_
+
+/*
+ * Declarations shared between the hash table modes.
+ * It is not a part of the public interface, include hash_table_uint32.h instead.
+ */
+
+#include "hash_table_uint32.h"
+#include "hash_table_uint32_hash.h"
+#include <stdint.h>
+
+// All table memory goes through the allocator of the table
+#define alloc_func(ht_ptr, size) ((ht_ptr)->allocator.alloc((ht_ptr)->allocator.context, (size)))
+#define free_func(ht_ptr, ptr, size) ((ht_ptr)->allocator.free((ht_ptr)->allocator.context, (ptr), (size)))
+
+// malloc and free, the allocator used when htui32_config_t has none
+extern const htui32_allocator_t htui32_default_allocator;
+
+// Receives every key and value of the table except the key 0
+typedef htui32_foreach_func_t htui32_item_visitor_t;
+
+// Calls the visitor for every key of the table except the key 0, in the order of the buckets (slots)
+extern void htui32_visit_items(hash_table_uint32_t* ht_ptr, htui32_item_visitor_t visitor, void* context);
+
+// Same as htui32_put, htui32_get and htui32_delete for a key the caller has already hashed, hash is htui32_hash(key)
+extern bool htui32_put_hashed(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value);
+extern bool htui32_get_hashed(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t* value_ptr);
+extern void htui32_delete_hashed(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash);
+
+// Minimum number of buckets cleared or moved by each put and delete during incremental rehashing
+#ifndef HTUI32_INCREMENTAL_REHASH_STEP
+#define HTUI32_INCREMENTAL_REHASH_STEP 8
+#endif
+
+// Number of keys hashed and prefetched ahead in batch operations
+#ifndef HTUI32_BATCH_PREFETCH_COUNT
+#define HTUI32_BATCH_PREFETCH_COUNT 16
+#endif
+
+// Number of items in the first block of the collision chain item pool (including the block header item)
+#define ITEM_POOL_MIN_BLOCK_ITEMS 16
+
+// Maximum number of items in a block of the collision chain item pool, 256 items are 4 KiB on 64-bit
+#ifndef HTUI32_ITEM_POOL_MAX_BLOCK_ITEMS
+#define HTUI32_ITEM_POOL_MAX_BLOCK_ITEMS 256
+#endif
+
+// Hints the processor to load the cache line with ptr, it does nothing on compilers without prefetch support
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#define htui32_prefetch(ptr) _mm_prefetch((const char*)(ptr), _MM_HINT_T0)
+#elif defined(__GNUC__) || defined(__clang__)
+#define htui32_prefetch(ptr) __builtin_prefetch(ptr)
+#else
+#define htui32_prefetch(ptr) ((void)(ptr))
+#endif
+
+// Adds n to the lifetime counter of the table, it compiles to nothing unless HTUI32_STATS is 1
+#if HTUI32_STATS
+#define HTUI32_COUNT(ht_ptr, counter, n) ((ht_ptr)->counters.counter += (n))
+#else
+#define HTUI32_COUNT(ht_ptr, counter, n) ((void)(n))
+#endif
+
+#if HTUI32_STATS
+#include <time.h>
+#endif
+
+// Timestamp in nanoseconds for the rehashing time counter, always 0 unless HTUI32_STATS is 1
+static inline uint64_t htui32_stats_now_ns(void)
+{
+#if HTUI32_STATS
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#else
+    return 0;
+#endif
+}
+
+// Returns the bucket (slot) position of the hash in a table part with capacity buckets
+static inline size_t htui32_reduce(const hash_table_uint32_t* ht_ptr, uint32_t hash, size_t capacity)
+{
+    switch (ht_ptr->reduction) {
+    case HTUI32_REDUCTION_MASK:
+        return hash & (capacity - 1);
+    case HTUI32_REDUCTION_FASTRANGE:
+        return (size_t)(((uint64_t)hash * capacity) >> 32);
+    default:
+        return hash % capacity;
+    }
+}
+
+// Item pool of the collision chains (hash_table_uint32_pool.c)
+
+// Initializes the empty pool, it does not allocate memory
+extern void htui32_pool_init(htui32_item_pool_t* pool_ptr);
+
+/*
+ * Takes an item for a collision chain from the item pool
+ * Released items are reused first, then the unused items of the last block, then a new block is allocated
+ * Returns NULL if the memory for a new block could not be allocated
+ */
+extern hash_table_uint32_item_t* htui32_pool_take(htui32_item_pool_t* pool_ptr, const htui32_allocator_t* allocator_ptr);
+
+// Returns the collision chain item to the item pool
+extern void htui32_pool_release(htui32_item_pool_t* pool_ptr, hash_table_uint32_item_t* item);
+
+// Returns the size of all blocks of the item pool in bytes
+extern size_t htui32_pool_memory_size(const htui32_item_pool_t* pool_ptr);
+
+// Frees all blocks of the item pool at once, collision chains do not have to be walked
+extern void htui32_pool_free(htui32_item_pool_t* pool_ptr, const htui32_allocator_t* allocator_ptr);
+
+// Open addressing modes (hash_table_uint32_open.c)
+// hash is always htui32_hash(key), it is passed in so that every operation hashes the key once
+
+/*
+ * Returns a pointer to the value of the key or NULL if the key is not in the table
+ * key must not be 0
+ */
+extern uint32_t* htui32_open_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash);
+
+/*
+ * Puts a new item, the key must not be in the table
+ * Returns false if there is no free slot
+ */
+extern bool htui32_open_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value);
+
+/*
+ * Returns a pointer to the value of the key, a missing key is put with value first and is_inserted_ptr is set to true then,
+ * the key is searched for and placed with one probe sequence
+ * Returns NULL if the key is missing and there is no free slot
+ */
+extern uint32_t* htui32_open_find_or_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, bool* is_inserted_ptr);
+
+/*
+ * Removes the key from the table
+ * Returns false if the key is not in the table
+ */
+extern bool htui32_open_remove(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash);
+
+// Returns the number of slots probed to find the key in the used slot pos
+extern size_t htui32_open_probe_length(hash_table_uint32_t* ht_ptr, size_t pos);
+
+// Prefetches the home slot of the hash
+extern void htui32_open_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash);
+
+/*
+ * Moves all items to the new slots array with new_capacity slots
+ * Returns false if the items do not fit or the memory could not be allocated, the table is left unchanged in this case
+ */
+extern bool htui32_open_rehash(hash_table_uint32_t* ht_ptr, size_t new_capacity);
+
+// Swiss table mode (hash_table_uint32_swiss.c), same contracts as the open addressing functions
+
+// Returns the capacity rounded up to the number of slots the Swiss table mode can use
+extern size_t htui32_swiss_round_capacity(size_t capacity);
+
+extern uint32_t* htui32_swiss_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash);
+
+extern bool htui32_swiss_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value);
+
+extern uint32_t* htui32_swiss_find_or_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, bool* is_inserted_ptr);
+
+extern bool htui32_swiss_remove(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash);
+
+// Returns the number of groups probed to find the key in the used slot pos
+extern size_t htui32_swiss_probe_length(hash_table_uint32_t* ht_ptr, size_t pos);
+
+// Returns true if the slot pos is used
+extern bool htui32_swiss_slot_is_used(hash_table_uint32_t* ht_ptr, size_t pos);
+
+// Prefetches the control bytes and slots of the first group of the hash
+extern void htui32_swiss_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash);
+
+// Rehashing to the same capacity turns the DELETED slots into EMPTY ones in place, without allocating memory
+extern bool htui32_swiss_rehash(hash_table_uint32_t* ht_ptr, size_t new_capacity);
+
+// Sets up capacity empty slots and their control bytes in memory of capacity * (sizeof(hash_table_uint32_slot_t) + 1) bytes
+extern void htui32_swiss_attach(hash_table_uint32_t* ht_ptr, void* memory, size_t capacity);
+
+// Snapshot mode (hash_table_uint32_snapshot.c)
+
+// Snapshot file format version, incremented on every incompatible change
+#define HTUI32_SNAPSHOT_VERSION 1
+
+/*
+ * Bucket or collision chain item of the snapshot file
+ * The buckets are the first capacity entries, the collision chain items follow them,
+ * next is the index of the next entry of the chain or 0 at its end (the entry 0 is a bucket, so it is never next)
+ */
+typedef struct {
+    uint32_t key;
+    uint32_t value;
+    uint32_t next;
+} htui32_snapshot_entry_t;
+
+// Returns the entries of the mapped snapshot
+extern const htui32_snapshot_entry_t* htui32_snapshot_entries(const hash_table_uint32_t* ht_ptr);
+
+// Returns the number of bucket and collision chain entries of the mapped snapshot
+extern size_t htui32_snapshot_entries_count(const hash_table_uint32_t* ht_ptr);
+
+// Same contract as htui32_open_find, the returned value must not be written
+extern uint32_t* htui32_snapshot_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash);
+
+// Prefetches the bucket of the hash
+extern void htui32_snapshot_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash);
+
+// Returns the number of keys in the collision chain of the bucket
+extern size_t htui32_snapshot_chain_length(const hash_table_uint32_t* ht_ptr, size_t bucket);
+
+// Unmaps the snapshot file
+extern void htui32_snapshot_unmap(hash_table_uint32_t* ht_ptr);
+
+// Frozen mode (hash_table_uint32_frozen.c)
+
+// Same contract as htui32_open_find, the returned value must not be written
+extern uint32_t* htui32_frozen_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash);
+
+// Prefetches the pilot of the hash, the slot is known only after the pilot is read
+extern void htui32_frozen_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash);
+
+// Compact chaining mode (hash_table_uint32_compact_chaining.c), same contracts as the open addressing functions
+
+extern uint32_t* htui32_compact_chaining_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash);
+
+extern bool htui32_compact_chaining_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value);
+
+// NULL is returned also if the memory for the chain items could not be allocated
+extern uint32_t* htui32_compact_chaining_find_or_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, bool* is_inserted_ptr);
+
+extern bool htui32_compact_chaining_remove(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash);
+
+// Returns the number of keys in the bucket at pos
+extern size_t htui32_compact_chaining_length(hash_table_uint32_t* ht_ptr, size_t pos);
+
+/*
+ * Reads the key with index chain_index of the bucket at pos (0 is the bucket itself), key_ptr gets 0 for an empty bucket
+ * Returns false if the bucket has no key with this index
+ */
+extern bool htui32_compact_chaining_read(hash_table_uint32_t* ht_ptr, size_t pos, size_t chain_index, uint32_t* key_ptr, uint32_t* value_ptr);
+
+// Calls the visitor for every key of the buckets and their chains
+extern void htui32_compact_chaining_visit(hash_table_uint32_t* ht_ptr, htui32_item_visitor_t visitor, void* context);
+
+extern void htui32_compact_chaining_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash);
+
+extern bool htui32_compact_chaining_rehash(hash_table_uint32_t* ht_ptr, size_t new_capacity);
+
+// Frees the buckets and the chain items
+extern void htui32_compact_chaining_free(hash_table_uint32_t* ht_ptr);
+
+// Cuckoo mode (hash_table_uint32_cuckoo.c), same contracts as the open addressing functions
+
+// Returns the capacity rounded up to the number of slots the cuckoo mode can use
+extern size_t htui32_cuckoo_round_capacity(size_t capacity);
+
+extern uint32_t* htui32_cuckoo_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash);
+
+// A key that does not fit into its buckets even after moving other keys grows the table, regardless of load_fac_max
+extern bool htui32_cuckoo_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value);
+
+extern uint32_t* htui32_cuckoo_find_or_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, bool* is_inserted_ptr);
+
+extern bool htui32_cuckoo_remove(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash);
+
+// Returns 1 if the used slot pos is in the first bucket of its key, 2 if it is in the second one
+extern size_t htui32_cuckoo_probe_length(hash_table_uint32_t* ht_ptr, size_t pos);
+
+// Prefetches both buckets of the hash
+extern void htui32_cuckoo_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash);
+
+extern bool htui32_cuckoo_rehash(hash_table_uint32_t* ht_ptr, size_t new_capacity);
+
+extern void htui32_cuckoo_free(hash_table_uint32_t* ht_ptr);
+
+#endif
@@ -0,0 +1,208 @@
+#include "hash_table_uint32_internal.h"
+#include <string.h>
+
+/*
+ * Open addressing modes of the hash table.
+ * Items are stored inline in slots_ptr, so no memory is allocated per item.
+ * The key 0 marks an empty slot (the key 0 itself is stored in zero_key_value),
+ * deletion uses backward shifting, so no tombstones are needed.
+ */
+
+static inline size_t next_pos(hash_table_uint32_t* ht_ptr, size_t pos)
+{
+    return (pos + 1 == ht_ptr->capacity) ? 0 : pos + 1;
+}
+
+static inline size_t home_pos(hash_table_uint32_t* ht_ptr, uint32_t key)
+{
+    return htui32_reduce(ht_ptr, htui32_hash(key), ht_ptr->capacity);
+}
+
+// Distance from the home position of the key to pos
+static inline size_t probe_distance(hash_table_uint32_t* ht_ptr, uint32_t key, size_t pos)
+{
+    size_t home = home_pos(ht_ptr, key);
+    return (pos >= home) ? pos - home : pos + ht_ptr->capacity - home;
+}
+
+/*
+ * Searches for the key and returns its slot position in pos_ptr
+ * If the key is not found, pos_ptr and dist_ptr get the slot where the search stopped and its distance from the home position,
+ * the key belongs to this slot (dist_ptr can be NULL)
+ * Returns true if the key is found, otherwise false
+ */
+static bool find_pos(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, size_t* pos_ptr, size_t* dist_ptr)
+{
+    hash_table_uint32_slot_t* slots = ht_ptr->slots_ptr;
+    size_t pos = htui32_reduce(ht_ptr, hash, ht_ptr->capacity);
+    HTUI32_COUNT(ht_ptr, lookups_count, 1);
+    for (size_t dist = 0; dist < ht_ptr->capacity; ++dist) {
+        HTUI32_COUNT(ht_ptr, probe_steps_count, 1);
+        uint32_t current_key = slots[pos].key;
+        if (current_key == key) {
+            *pos_ptr = pos;
+            return true;
+        }
+        // Robin Hood keeps items ordered by probe distance,
+        // so the key cannot be further than an item that is closer to its home position
+        if (current_key == 0 || (ht_ptr->mode == HTUI32_MODE_ROBIN_HOOD && probe_distance(ht_ptr, current_key, pos) < dist)) {
+            *pos_ptr = pos;
+            if (dist_ptr != NULL) {
+                *dist_ptr = dist;
+            }
+            return false;
+        }
+        pos = next_pos(ht_ptr, pos);
+    }
+    return false;
+}
+
+/*
+ * Puts the item to the first suitable slot starting from pos, dist is the distance of pos from the home position of the key
+ * There must be at least one free slot
+ */
+static void place_item(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t value, size_t pos, size_t dist)
+{
+    hash_table_uint32_slot_t* slots = ht_ptr->slots_ptr;
+    while (true) {
+        hash_table_uint32_slot_t* slot = &slots[pos];
+        if (slot->key == 0) {
+            slot->key = key;
+            slot->value = value;
+            return;
+        }
+        if (ht_ptr->mode == HTUI32_MODE_ROBIN_HOOD) {
+            // Take the slot from the item that is closer to its home position and continue with it
+            size_t current_dist = probe_distance(ht_ptr, slot->key, pos);
+            if (current_dist < dist) {
+                hash_table_uint32_slot_t evicted = *slot;
+                slot->key = key;
+                slot->value = value;
+                key = evicted.key;
+                value = evicted.value;
+                dist = current_dist;
+            }
+        }
+        pos = next_pos(ht_ptr, pos);
+        dist++;
+    }
+}
+
+uint32_t* htui32_open_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    size_t pos = 0;
+    if (find_pos(ht_ptr, key, hash, &pos, NULL)) {
+        return &ht_ptr->slots_ptr[pos].value;
+    }
+    return NULL;
+}
+
+// At least one slot must stay free, otherwise probing for a missing key never stops on an empty slot
+static inline bool has_free_slot(hash_table_uint32_t* ht_ptr)
+{
+    size_t used_slots = ht_ptr->size - (ht_ptr->zero_key_is_used ? 1 : 0);
+    return used_slots + 1 < ht_ptr->capacity;
+}
+
+bool htui32_open_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value)
+{
+    if (!has_free_slot(ht_ptr)) {
+        return false;
+    }
+    place_item(ht_ptr, key, value, htui32_reduce(ht_ptr, hash, ht_ptr->capacity), 0);
+    return true;
+}
+
+uint32_t* htui32_open_find_or_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, bool* is_inserted_ptr)
+{
+    size_t pos = 0;
+    size_t dist = 0;
+    if (find_pos(ht_ptr, key, hash, &pos, &dist)) {
+        return &ht_ptr->slots_ptr[pos].value;
+    }
+    if (!has_free_slot(ht_ptr)) {
+        return NULL;
+    }
+    // The search stopped at the slot of the key, Robin Hood moves the item of this slot further
+    place_item(ht_ptr, key, value, pos, dist);
+    *is_inserted_ptr = true;
+    return &ht_ptr->slots_ptr[pos].value;
+}
+
+bool htui32_open_remove(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    size_t hole = 0;
+    if (!find_pos(ht_ptr, key, hash, &hole, NULL)) {
+        return false;
+    }
+    hash_table_uint32_slot_t* slots = ht_ptr->slots_ptr;
+    // Shift the following items of the cluster back, so that lookups never meet a gap before their key
+    size_t pos = next_pos(ht_ptr, hole);
+    while (slots[pos].key != 0) {
+        bool can_move = false;
+        if (ht_ptr->mode == HTUI32_MODE_ROBIN_HOOD) {
+            // The cluster ends at the first item that is in its home position
+            if (probe_distance(ht_ptr, slots[pos].key, pos) == 0) {
+                break;
+            }
+            can_move = true;
+        }
+        else {
+            // The item can be moved to the hole only if its home position is not in (hole, pos]
+            size_t home = home_pos(ht_ptr, slots[pos].key);
+            if (hole <= pos) {
+                can_move = home <= hole || home > pos;
+            }
+            else {
+                can_move = home <= hole && home > pos;
+            }
+        }
+        if (can_move) {
+            slots[hole] = slots[pos];
+            hole = pos;
+        }
+        pos = next_pos(ht_ptr, pos);
+    }
+    slots[hole].key = 0;
+    slots[hole].value = 0;
+    return true;
+}
+
+size_t htui32_open_probe_length(hash_table_uint32_t* ht_ptr, size_t pos)
+{
+    return probe_distance(ht_ptr, ht_ptr->slots_ptr[pos].key, pos) + 1;
+}
+
+void htui32_open_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash)
+{
+    htui32_prefetch(&ht_ptr->slots_ptr[htui32_reduce(ht_ptr, hash, ht_ptr->capacity)]);
+}
+
+bool htui32_open_rehash(hash_table_uint32_t* ht_ptr, size_t new_capacity)
+{
+    size_t used_slots = ht_ptr->size - (ht_ptr->zero_key_is_used ? 1 : 0);
+    if (used_slots >= new_capacity) {
+        return false;
+    }
+    size_t new_memory_size = new_capacity * sizeof(hash_table_uint32_slot_t);
+    hash_table_uint32_slot_t* new_slots = alloc_func(ht_ptr, new_memory_size);
+    if (new_slots == NULL) {
+        return false;
+    }
+    memset(new_slots, 0, new_memory_size);
+    hash_table_uint32_slot_t* old_slots = ht_ptr->slots_ptr;
+    size_t old_capacity = ht_ptr->capacity;
+    ht_ptr->slots_ptr = new_slots;
+    ht_ptr->capacity = new_capacity;
+    ht_ptr->memory_size = new_memory_size;
+    // Copy items to new slots, keys are unique so they are placed without lookup
+    for (size_t i = 0; i < old_capacity; ++i) {
+        if (old_slots[i].key != 0) {
+            place_item(ht_ptr, old_slots[i].key, old_slots[i].value, home_pos(ht_ptr, old_slots[i].key), 0);
+        }
+    }
+    if (old_slots != NULL) {
+        free_func(ht_ptr, old_slots, old_capacity * sizeof(hash_table_uint32_slot_t));
+    }
+    return true;
+}
@@ -0,0 +1,73 @@
+#include "hash_table_uint32_internal.h"
+#include "hash_table_uint32_atomic.h"
+
+/*
+ * Item pool of the collision chains.
+ * Items are cut from blocks allocated through the allocator of the table, released items are kept in a free list.
+ */
+
+void htui32_pool_init(htui32_item_pool_t* pool_ptr)
+{
+    pool_ptr->item_blocks_ptr = NULL;
+    pool_ptr->free_items_ptr = NULL;
+    pool_ptr->block_items_begin = NULL;
+    pool_ptr->block_items_end = NULL;
+}
+
+hash_table_uint32_item_t* htui32_pool_take(htui32_item_pool_t* pool_ptr, const htui32_allocator_t* allocator_ptr)
+{
+    hash_table_uint32_item_t* item = pool_ptr->free_items_ptr;
+    if (item != NULL) {
+        pool_ptr->free_items_ptr = item->next;
+        return item;
+    }
+    if (pool_ptr->block_items_begin == pool_ptr->block_items_end) {
+        // Each next block is twice as large as the previous one
+        size_t items_count = ITEM_POOL_MIN_BLOCK_ITEMS;
+        if (pool_ptr->item_blocks_ptr != NULL) {
+            items_count = pool_ptr->item_blocks_ptr->key * 2;
+            if (items_count > HTUI32_ITEM_POOL_MAX_BLOCK_ITEMS) {
+                items_count = HTUI32_ITEM_POOL_MAX_BLOCK_ITEMS;
+            }
+        }
+        hash_table_uint32_item_t* block = allocator_ptr->alloc(allocator_ptr->context, items_count * sizeof(hash_table_uint32_item_t));
+        if (block == NULL) {
+            return NULL;
+        }
+        // The first item of the block is its header: next links the blocks, key is the number of items in the block
+        block->next = pool_ptr->item_blocks_ptr;
+        block->key = (uint32_t)items_count;
+        block->value = 0;
+        pool_ptr->item_blocks_ptr = block;
+        pool_ptr->block_items_begin = block + 1;
+        pool_ptr->block_items_end = block + items_count;
+    }
+    return pool_ptr->block_items_begin++;
+}
+
+void htui32_pool_release(htui32_item_pool_t* pool_ptr, hash_table_uint32_item_t* item)
+{
+    // Lockless gets of the concurrent table may still be reading the item
+    htui32_atomic_store_ptr((void**)&item->next, pool_ptr->free_items_ptr);
+    pool_ptr->free_items_ptr = item;
+}
+
+size_t htui32_pool_memory_size(const htui32_item_pool_t* pool_ptr)
+{
+    size_t memory_size = 0;
+    for (hash_table_uint32_item_t* block = pool_ptr->item_blocks_ptr; block != NULL; block = block->next) {
+        memory_size += block->key * sizeof(hash_table_uint32_item_t);
+    }
+    return memory_size;
+}
+
+void htui32_pool_free(htui32_item_pool_t* pool_ptr, const htui32_allocator_t* allocator_ptr)
+{
+    hash_table_uint32_item_t* block = pool_ptr->item_blocks_ptr;
+    while (block != NULL) {
+        hash_table_uint32_item_t* next_block = block->next;
+        allocator_ptr->free(allocator_ptr->context, block, block->key * sizeof(hash_table_uint32_item_t));
+        block = next_block;
+    }
+    htui32_pool_init(pool_ptr);
+}
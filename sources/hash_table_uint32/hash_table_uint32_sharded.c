@@ -0,0 +1,250 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "hash_table_uint32_sharded.h"
+#include "hash_table_uint32_internal.h"
+#include "hash_table_uint32_sync.h"
+#include <string.h>
+
+/*
+ * Sharded table.
+ * The shard is the high shard_bits of the hash, the table of the shard reduces the same hash by its low bits,
+ * so the keys of one shard are still spread over all its buckets.
+ */
+
+// Size of the padding that keeps the fields of neighbouring shards on different cache lines
+#ifndef HTUI32_CACHE_LINE_SIZE
+#define HTUI32_CACHE_LINE_SIZE 64
+#endif
+
+struct htui32_shard {
+    // Protects the table of the shard (not used with thread-affine shards)
+    htui32_rwlock_t lock;
+    hash_table_uint32_t table;
+    char padding[HTUI32_CACHE_LINE_SIZE];
+};
+
+static inline htui32_shard_t* get_shard(htui32_sharded_t* ht_ptr, uint32_t hash)
+{
+    // The shift of a 64-bit value is defined for 0 bits too
+    return &ht_ptr->shards_ptr[((uint64_t)hash << ht_ptr->shard_bits) >> 32];
+}
+
+static inline void read_lock(htui32_sharded_t* ht_ptr, htui32_shard_t* shard_ptr)
+{
+    if (!ht_ptr->thread_affine) {
+        htui32_rwlock_read_lock(&shard_ptr->lock);
+    }
+}
+
+static inline void read_unlock(htui32_sharded_t* ht_ptr, htui32_shard_t* shard_ptr)
+{
+    if (!ht_ptr->thread_affine) {
+        htui32_rwlock_read_unlock(&shard_ptr->lock);
+    }
+}
+
+static inline void write_lock(htui32_sharded_t* ht_ptr, htui32_shard_t* shard_ptr)
+{
+    if (!ht_ptr->thread_affine) {
+        htui32_rwlock_write_lock(&shard_ptr->lock);
+    }
+}
+
+static inline void write_unlock(htui32_sharded_t* ht_ptr, htui32_shard_t* shard_ptr)
+{
+    if (!ht_ptr->thread_affine) {
+        htui32_rwlock_write_unlock(&shard_ptr->lock);
+    }
+}
+
+// Gets change the lifetime counters of the shard table when they are enabled, so then they lock the shard exclusively
+static inline void get_lock(htui32_sharded_t* ht_ptr, htui32_shard_t* shard_ptr)
+{
+#if HTUI32_STATS
+    write_lock(ht_ptr, shard_ptr);
+#else
+    read_lock(ht_ptr, shard_ptr);
+#endif
+}
+
+static inline void get_unlock(htui32_sharded_t* ht_ptr, htui32_shard_t* shard_ptr)
+{
+#if HTUI32_STATS
+    write_unlock(ht_ptr, shard_ptr);
+#else
+    read_unlock(ht_ptr, shard_ptr);
+#endif
+}
+
+// Frees the shards from shards_count - 1 down to 0
+static void free_shards(htui32_sharded_t* ht_ptr, size_t shards_count)
+{
+    for (size_t i = shards_count; i-- > 0;) {
+        htui32_shard_t* shard_ptr = &ht_ptr->shards_ptr[i];
+        htui32_destroy(&shard_ptr->table);
+        if (!ht_ptr->thread_affine) {
+            htui32_rwlock_destroy(&shard_ptr->lock);
+        }
+    }
+    ht_ptr->allocator.free(ht_ptr->allocator.context, ht_ptr->shards_ptr, ht_ptr->shards_count * sizeof(htui32_shard_t));
+    ht_ptr->shards_ptr = NULL;
+}
+
+void htui32_sharded_init(htui32_sharded_t* ht_ptr, const htui32_sharded_config_t* config_ptr)
+{
+    if (ht_ptr == NULL) {
+        return;
+    }
+    htui32_sharded_config_t default_config;
+    if (config_ptr == NULL) {
+        memset(&default_config, 0, sizeof(default_config));
+        config_ptr = &default_config;
+    }
+    ht_ptr->shards_ptr = NULL;
+    ht_ptr->thread_affine = config_ptr->thread_affine;
+    ht_ptr->allocator = (config_ptr->shard_config.allocator != NULL) ? *config_ptr->shard_config.allocator : htui32_default_allocator;
+
+    size_t requested_count = (config_ptr->shards_count != 0) ? config_ptr->shards_count : HTUI32_SHARDED_DEFAULT_SHARDS;
+    if (requested_count > HTUI32_SHARDED_MAX_SHARDS) {
+        requested_count = HTUI32_SHARDED_MAX_SHARDS;
+    }
+    ht_ptr->shards_count = 1;
+    ht_ptr->shard_bits = 0;
+    while (ht_ptr->shards_count < requested_count) {
+        ht_ptr->shards_count *= 2;
+        ht_ptr->shard_bits++;
+    }
+
+    htui32_config_t shard_config = config_ptr->shard_config;
+    if (shard_config.reduction == HTUI32_REDUCTION_FASTRANGE) {
+        shard_config.reduction = HTUI32_REDUCTION_MASK;
+    }
+
+    size_t shards_size = ht_ptr->shards_count * sizeof(htui32_shard_t);
+    ht_ptr->shards_ptr = ht_ptr->allocator.alloc(ht_ptr->allocator.context, shards_size);
+    if (ht_ptr->shards_ptr == NULL) {
+        return;
+    }
+    memset(ht_ptr->shards_ptr, 0, shards_size);
+    for (size_t i = 0; i < ht_ptr->shards_count; ++i) {
+        htui32_shard_t* shard_ptr = &ht_ptr->shards_ptr[i];
+        htui32_init_ex(&shard_ptr->table, &shard_config);
+        if (shard_ptr->table.capacity == 0) {
+            free_shards(ht_ptr, i);
+            return;
+        }
+        if (!ht_ptr->thread_affine) {
+            htui32_rwlock_init(&shard_ptr->lock);
+        }
+    }
+}
+
+bool htui32_sharded_put(htui32_sharded_t* ht_ptr, uint32_t key, uint32_t value)
+{
+    if (ht_ptr == NULL || ht_ptr->shards_ptr == NULL) {
+        return false;
+    }
+    uint32_t hash = htui32_hash(key);
+    htui32_shard_t* shard_ptr = get_shard(ht_ptr, hash);
+    write_lock(ht_ptr, shard_ptr);
+    bool is_put = htui32_put_hashed(&shard_ptr->table, key, hash, value);
+    write_unlock(ht_ptr, shard_ptr);
+    return is_put;
+}
+
+bool htui32_sharded_get(htui32_sharded_t* ht_ptr, uint32_t key, uint32_t* value_ptr)
+{
+    if (ht_ptr == NULL || ht_ptr->shards_ptr == NULL) {
+        return false;
+    }
+    uint32_t hash = htui32_hash(key);
+    htui32_shard_t* shard_ptr = get_shard(ht_ptr, hash);
+    get_lock(ht_ptr, shard_ptr);
+    bool has_found = htui32_get_hashed(&shard_ptr->table, key, hash, value_ptr);
+    get_unlock(ht_ptr, shard_ptr);
+    return has_found;
+}
+
+void htui32_sharded_delete(htui32_sharded_t* ht_ptr, uint32_t key)
+{
+    if (ht_ptr == NULL || ht_ptr->shards_ptr == NULL) {
+        return;
+    }
+    uint32_t hash = htui32_hash(key);
+    htui32_shard_t* shard_ptr = get_shard(ht_ptr, hash);
+    write_lock(ht_ptr, shard_ptr);
+    htui32_delete_hashed(&shard_ptr->table, key, hash);
+    write_unlock(ht_ptr, shard_ptr);
+}
+
+size_t htui32_sharded_shard_of(htui32_sharded_t* ht_ptr, uint32_t key)
+{
+    if (ht_ptr == NULL || ht_ptr->shards_ptr == NULL) {
+        return 0;
+    }
+    return (size_t)(get_shard(ht_ptr, htui32_hash(key)) - ht_ptr->shards_ptr);
+}
+
+size_t htui32_sharded_size(htui32_sharded_t* ht_ptr)
+{
+    if (ht_ptr == NULL || ht_ptr->shards_ptr == NULL) {
+        return 0;
+    }
+    size_t size = 0;
+    for (size_t i = 0; i < ht_ptr->shards_count; ++i) {
+        htui32_shard_t* shard_ptr = &ht_ptr->shards_ptr[i];
+        read_lock(ht_ptr, shard_ptr);
+        size += shard_ptr->table.size;
+        read_unlock(ht_ptr, shard_ptr);
+    }
+    return size;
+}
+
+void htui32_sharded_stats(htui32_sharded_t* ht_ptr, htui32_stats_t* stats_ptr)
+{
+    if (ht_ptr == NULL || stats_ptr == NULL || ht_ptr->shards_ptr == NULL) {
+        return;
+    }
+    memset(stats_ptr, 0, sizeof(*stats_ptr));
+    stats_ptr->counters_enabled = HTUI32_STATS;
+    stats_ptr->memory_bytes = ht_ptr->shards_count * sizeof(htui32_shard_t);
+    // Sum of the chain lengths of all shards multiplied by 100, the means of the shards are weighted by their used buckets
+    size_t total_length_x100 = 0;
+    for (size_t i = 0; i < ht_ptr->shards_count; ++i) {
+        htui32_shard_t* shard_ptr = &ht_ptr->shards_ptr[i];
+        htui32_stats_t shard_stats;
+        read_lock(ht_ptr, shard_ptr);
+        htui32_stats(&shard_ptr->table, &shard_stats);
+        read_unlock(ht_ptr, shard_ptr);
+
+        stats_ptr->size += shard_stats.size;
+        stats_ptr->capacity += shard_stats.capacity;
+        stats_ptr->used_buckets += shard_stats.used_buckets;
+        if (shard_stats.max_chain_length > stats_ptr->max_chain_length) {
+            stats_ptr->max_chain_length = shard_stats.max_chain_length;
+        }
+        total_length_x100 += shard_stats.mean_chain_length_x100 * shard_stats.used_buckets;
+        for (size_t j = 0; j < HTUI32_STATS_HISTOGRAM_SIZE; ++j) {
+            stats_ptr->chain_length_histogram[j] += shard_stats.chain_length_histogram[j];
+        }
+        stats_ptr->overflow_items += shard_stats.overflow_items;
+        stats_ptr->memory_bytes += shard_stats.memory_bytes;
+        stats_ptr->counters.grow_count += shard_stats.counters.grow_count;
+        stats_ptr->counters.shrink_count += shard_stats.counters.shrink_count;
+        stats_ptr->counters.rehash_time_ns += shard_stats.counters.rehash_time_ns;
+        stats_ptr->counters.lookups_count += shard_stats.counters.lookups_count;
+        stats_ptr->counters.probe_steps_count += shard_stats.counters.probe_steps_count;
+    }
+    if (stats_ptr->used_buckets != 0) {
+        stats_ptr->mean_chain_length_x100 = total_length_x100 / stats_ptr->used_buckets;
+    }
+}
+
+void htui32_sharded_destroy(htui32_sharded_t* ht_ptr)
+{
+    if (ht_ptr == NULL || ht_ptr->shards_ptr == NULL) {
+        return;
+    }
+    free_shards(ht_ptr, ht_ptr->shards_count);
+}
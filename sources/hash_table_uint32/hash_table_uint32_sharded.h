@@ -0,0 +1,133 @@
+#ifndef _HASH_TABLE_UINT32_SHARDED_
+#define _HASH_TABLE_UINT32_SHARDED_
+
+/*
+ * Sharded hash table for keys and values of uint32_t type.
+ * Keys are split between independent hash_table_uint32_t shards by the high bits of their hash,
+ * every shard has its own memory, its own lock and its own rehashing, so threads working on different shards
+ * do not share cache lines and a resize stops only the users of one shard.
+ * The shards look the key up by the low bits of the same hash, so the key is hashed once per operation.
+ *
+ * By default every shard is protected by a read-write lock and any thread can use any key.
+ * With thread-affine shards nothing is locked: the application gives every shard to one thread
+ * (htui32_sharded_shard_of tells the shard of a key) and only that thread uses the keys of the shard.
+ */
+
+#include "hash_table_uint32.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Shard of the sharded table, defined in hash_table_uint32_sharded.c
+typedef struct htui32_shard htui32_shard_t;
+
+// Number of shards used when 0 is requested, can be overridden at compile time
+#ifndef HTUI32_SHARDED_DEFAULT_SHARDS
+#define HTUI32_SHARDED_DEFAULT_SHARDS 16
+#endif
+
+// Largest number of shards
+#define HTUI32_SHARDED_MAX_SHARDS 65536
+
+typedef struct {
+    // Shards, each one on its own cache lines
+    htui32_shard_t* shards_ptr;
+    // Number of shards, a power of two
+    size_t shards_count;
+    // log2(shards_count), the shard of a key is this many high bits of its hash
+    uint32_t shard_bits;
+    // Shards are not locked, every shard is used by one thread only
+    bool thread_affine;
+    // Memory allocator of the shard array
+    htui32_allocator_t allocator;
+} htui32_sharded_t;
+
+// Table parameters for htui32_sharded_init, zero in any field means the default value
+typedef struct {
+    // Number of shards, rounded up to a power of two (HTUI32_SHARDED_DEFAULT_SHARDS by default, at most HTUI32_SHARDED_MAX_SHARDS)
+    size_t shards_count;
+    // Shards are not locked, the application must use the keys of a shard from one thread only
+    bool thread_affine;
+    // Parameters of every shard, capacity is the initial capacity of one shard.
+    // The fastrange reduction takes the high hash bits that select the shard, the shards use the mask reduction instead.
+    // Without thread_affine the allocator must be thread-safe
+    htui32_config_t shard_config;
+} htui32_sharded_config_t;
+
+/*
+ * Initializes the table
+ * The table stays unusable (shards_ptr is NULL) if the memory could not be allocated, the other functions do nothing in this case
+ *
+ * ht_ptr - pointer to hash table
+ * config_ptr - table parameters (NULL for the default values)
+ */
+extern void htui32_sharded_init(htui32_sharded_t* ht_ptr, const htui32_sharded_config_t* config_ptr);
+
+/*
+ * Puts value by key
+ * Returns false if the key is new and could not be put (see htui32_put)
+ *
+ * ht_ptr - pointer to hash table
+ * key - key
+ * value - value
+ */
+extern bool htui32_sharded_put(htui32_sharded_t* ht_ptr, uint32_t key, uint32_t value);
+
+/*
+ * Gets value by key
+ *
+ * ht_ptr - pointer to hash table
+ * key - key
+ * value_ptr - pointer to the variable in which the value will be written (can be NULL)
+ *
+ * Returns true if the key is found, otherwise false
+ */
+extern bool htui32_sharded_get(htui32_sharded_t* ht_ptr, uint32_t key, uint32_t* value_ptr);
+
+/*
+ * Deletes value by key
+ *
+ * ht_ptr - pointer to hash table
+ * key - key
+ */
+extern void htui32_sharded_delete(htui32_sharded_t* ht_ptr, uint32_t key);
+
+/*
+ * Returns the index of the shard of the key, from 0 to shards_count - 1
+ *
+ * ht_ptr - pointer to hash table
+ * key - key
+ */
+extern size_t htui32_sharded_shard_of(htui32_sharded_t* ht_ptr, uint32_t key);
+
+/*
+ * Returns the number of keys in the table
+ * The shards are counted one after another, so with concurrent puts and deletes the result is approximate,
+ * with thread-affine shards no shard may be changed meanwhile
+ *
+ * ht_ptr - pointer to hash table
+ */
+extern size_t htui32_sharded_size(htui32_sharded_t* ht_ptr);
+
+/*
+ * Fills the statistics of all shards together: the sizes, capacities, buckets, histograms, memory and counters are added up,
+ * max_chain_length is the longest chain of any shard. The same rules as for htui32_sharded_size apply
+ *
+ * ht_ptr - pointer to hash table
+ * stats_ptr - pointer to the statistics to fill
+ */
+extern void htui32_sharded_stats(htui32_sharded_t* ht_ptr, htui32_stats_t* stats_ptr);
+
+/*
+ * Frees the table memory, no other function may be running on the table
+ *
+ * ht_ptr - pointer to hash table
+ */
+extern void htui32_sharded_destroy(htui32_sharded_t* ht_ptr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,278 @@
+#if !defined(_WIN32) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "hash_table_uint32_internal.h"
+#include <stdio.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Snapshot files of the hash table.
+ * A snapshot is a chaining mode table laid out in one file: the header, then the bucket entries, then the collision chain entries.
+ * Whatever mode the table was in, its keys are saved into chains of the same capacity and reduction,
+ * so a mapped snapshot is searched in place with the usual hash and reduction of the table.
+ */
+
+#define SNAPSHOT_MAGIC "HTUI32SN"
+// Written as a number, read back differently on a machine with another byte order
+#define SNAPSHOT_BYTE_ORDER 0x01020304u
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    // HTUI32_HASH the buckets were computed with
+    uint32_t hash_id;
+    // Seed of the hash function, the hash functions of the table are not seeded yet, so it is always 0
+    uint32_t hash_seed;
+    uint32_t reduction;
+    uint32_t zero_key_is_used;
+    uint32_t zero_key_value;
+    uint32_t reserved;
+    // Number of bucket entries
+    uint64_t capacity;
+    // Number of keys, including the key 0
+    uint64_t size;
+    // Number of all entries, buckets and collision chain items
+    uint64_t entries_count;
+} snapshot_header_t;
+
+const htui32_snapshot_entry_t* htui32_snapshot_entries(const hash_table_uint32_t* ht_ptr)
+{
+    return (const htui32_snapshot_entry_t*)((const char*)ht_ptr->snapshot_ptr + sizeof(snapshot_header_t));
+}
+
+size_t htui32_snapshot_entries_count(const hash_table_uint32_t* ht_ptr)
+{
+    return (size_t)((const snapshot_header_t*)ht_ptr->snapshot_ptr)->entries_count;
+}
+
+uint32_t* htui32_snapshot_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    const htui32_snapshot_entry_t* entries = htui32_snapshot_entries(ht_ptr);
+    size_t entries_count = htui32_snapshot_entries_count(ht_ptr);
+    uint32_t index = (uint32_t)htui32_reduce(ht_ptr, hash, ht_ptr->capacity);
+    HTUI32_COUNT(ht_ptr, lookups_count, 1);
+    // A chain is never longer than the number of keys, a damaged file can not send the search out of the mapping or around a loop
+    for (size_t steps = 0; steps <= ht_ptr->size; ++steps) {
+        HTUI32_COUNT(ht_ptr, probe_steps_count, 1);
+        if (entries[index].key == key) {
+            return (uint32_t*)&entries[index].value;
+        }
+        index = entries[index].next;
+        if (index == 0 || index >= entries_count) {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+size_t htui32_snapshot_chain_length(const hash_table_uint32_t* ht_ptr, size_t bucket)
+{
+    const htui32_snapshot_entry_t* entries = htui32_snapshot_entries(ht_ptr);
+    size_t entries_count = htui32_snapshot_entries_count(ht_ptr);
+    if (entries[bucket].key == 0) {
+        return 0;
+    }
+    size_t length = 1;
+    for (uint32_t index = entries[bucket].next; index != 0 && index < entries_count && length <= ht_ptr->size; index = entries[index].next) {
+        ++length;
+    }
+    return length;
+}
+
+void htui32_snapshot_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash)
+{
+    htui32_prefetch(&htui32_snapshot_entries(ht_ptr)[htui32_reduce(ht_ptr, hash, ht_ptr->capacity)]);
+}
+
+typedef struct {
+    const hash_table_uint32_t* ht_ptr;
+    htui32_snapshot_entry_t* entries;
+    uint32_t entries_count;
+} snapshot_builder_t;
+
+// Puts the key to the chain of its bucket, the new collision chain entry is linked right after the bucket entry
+static void add_entry(void* context, uint32_t key, uint32_t value)
+{
+    snapshot_builder_t* builder = context;
+    htui32_snapshot_entry_t* entries = builder->entries;
+    htui32_snapshot_entry_t* bucket = &entries[htui32_reduce(builder->ht_ptr, htui32_hash(key), builder->ht_ptr->capacity)];
+    if (bucket->key == 0) {
+        bucket->key = key;
+        bucket->value = value;
+        return;
+    }
+    uint32_t index = builder->entries_count++;
+    entries[index].key = key;
+    entries[index].value = value;
+    entries[index].next = bucket->next;
+    bucket->next = index;
+}
+
+bool htui32_save(hash_table_uint32_t* ht_ptr, const char* path)
+{
+    if (ht_ptr == NULL || path == NULL || ht_ptr->capacity == 0) {
+        return false;
+    }
+    // Entries are linked by 32-bit indexes
+    size_t max_entries_count = ht_ptr->capacity + ht_ptr->size;
+    if (max_entries_count > UINT32_MAX) {
+        return false;
+    }
+    size_t entries_size = max_entries_count * sizeof(htui32_snapshot_entry_t);
+    htui32_snapshot_entry_t* entries = alloc_func(ht_ptr, entries_size);
+    if (entries == NULL) {
+        return false;
+    }
+    memset(entries, 0, entries_size);
+    snapshot_builder_t builder = { ht_ptr, entries, (uint32_t)ht_ptr->capacity };
+    htui32_visit_items(ht_ptr, add_entry, &builder);
+    uint32_t entries_count = builder.entries_count;
+
+    snapshot_header_t header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+    header.version = HTUI32_SNAPSHOT_VERSION;
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.hash_id = HTUI32_HASH;
+    header.hash_seed = 0;
+    header.reduction = ht_ptr->reduction;
+    header.zero_key_is_used = ht_ptr->zero_key_is_used;
+    header.zero_key_value = ht_ptr->zero_key_value;
+    header.capacity = ht_ptr->capacity;
+    header.size = ht_ptr->size;
+    header.entries_count = entries_count;
+
+    bool is_saved = false;
+    FILE* file = fopen(path, "wb");
+    if (file != NULL) {
+        is_saved = fwrite(&header, sizeof(header), 1, file) == 1
+            && fwrite(entries, sizeof(htui32_snapshot_entry_t), entries_count, file) == entries_count;
+        is_saved = (fclose(file) == 0) && is_saved;
+    }
+    free_func(ht_ptr, entries, entries_size);
+    return is_saved;
+}
+
+// Maps the whole file read-only, returns NULL if it could not be mapped
+static const void* map_file(const char* path, size_t* size_ptr)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    const void* ptr = NULL;
+    LARGE_INTEGER file_size;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart != 0 && (uint64_t)file_size.QuadPart <= SIZE_MAX) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (mapping != NULL) {
+            // The view keeps the mapping alive after its handle is closed
+            ptr = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+            *size_ptr = (size_t)file_size.QuadPart;
+        }
+    }
+    CloseHandle(file);
+    return ptr;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    const void* ptr = NULL;
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size != 0 && (uint64_t)file_stat.st_size <= SIZE_MAX) {
+        void* mapped_ptr = mmap(NULL, (size_t)file_stat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+        if (mapped_ptr != MAP_FAILED) {
+            ptr = mapped_ptr;
+            *size_ptr = (size_t)file_stat.st_size;
+        }
+    }
+    // The mapping stays after the file is closed
+    close(fd);
+    return ptr;
+#endif
+}
+
+static void unmap_file(const void* ptr, size_t size)
+{
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(ptr);
+#else
+    munmap((void*)ptr, size);
+#endif
+}
+
+// Checks that the mapped file is a snapshot this build can search
+static bool header_is_valid(const snapshot_header_t* header, size_t file_size)
+{
+    if (file_size < sizeof(snapshot_header_t) || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0) {
+        return false;
+    }
+    if (header->version != HTUI32_SNAPSHOT_VERSION || header->byte_order != SNAPSHOT_BYTE_ORDER) {
+        return false;
+    }
+    // The buckets were computed with another hash function
+    if (header->hash_id != HTUI32_HASH || header->hash_seed != 0) {
+        return false;
+    }
+    if (header->reduction < HTUI32_REDUCTION_MODULO || header->reduction > HTUI32_REDUCTION_FASTRANGE) {
+        return false;
+    }
+    if (header->capacity == 0 || header->capacity > header->entries_count || header->entries_count > UINT32_MAX) {
+        return false;
+    }
+    return (file_size - sizeof(snapshot_header_t)) / sizeof(htui32_snapshot_entry_t) >= header->entries_count;
+}
+
+bool htui32_open_mmap(hash_table_uint32_t* ht_ptr, const char* path)
+{
+    if (ht_ptr == NULL || path == NULL) {
+        return false;
+    }
+    size_t file_size = 0;
+    const void* file_ptr = map_file(path, &file_size);
+    if (file_ptr == NULL) {
+        return false;
+    }
+    const snapshot_header_t* header = file_ptr;
+    if (!header_is_valid(header, file_size)) {
+        unmap_file(file_ptr, file_size);
+        return false;
+    }
+
+    // Nothing is allocated, the allocator is only used by htui32_save of the mapped table
+    memset(ht_ptr, 0, sizeof(*ht_ptr));
+    ht_ptr->allocator = htui32_default_allocator;
+    ht_ptr->mode = HTUI32_MODE_SNAPSHOT;
+    ht_ptr->reduction = (htui32_reduction_t)header->reduction;
+    ht_ptr->capacity = (size_t)header->capacity;
+    ht_ptr->initial_capacity = ht_ptr->capacity;
+    ht_ptr->size = (size_t)header->size;
+    ht_ptr->zero_key_is_used = header->zero_key_is_used != 0;
+    ht_ptr->zero_key_value = header->zero_key_value;
+    ht_ptr->snapshot_ptr = file_ptr;
+    ht_ptr->snapshot_size = file_size;
+    return true;
+}
+
+void htui32_snapshot_unmap(hash_table_uint32_t* ht_ptr)
+{
+    if (ht_ptr->snapshot_ptr != NULL) {
+        unmap_file(ht_ptr->snapshot_ptr, ht_ptr->snapshot_size);
+        ht_ptr->snapshot_ptr = NULL;
+        ht_ptr->snapshot_size = 0;
+    }
+}
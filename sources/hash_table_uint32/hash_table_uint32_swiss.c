@@ -0,0 +1,358 @@
+#include "hash_table_uint32_internal.h"
+#include <string.h>
+
+/*
+ * Swiss table mode of the hash table.
+ * Every slot has a control byte: EMPTY, DELETED or the 7-bit hash fragment (h2) of the key in the slot.
+ * Slots are split into groups of GROUP_WIDTH, the control bytes of a whole group are compared with h2 at once,
+ * so a lookup usually reads one group of control bytes and compares one key.
+ * Groups are probed in triangular order, which visits every group since the number of groups is a power of two.
+ */
+
+#if !defined(HTUI32_SWISS_NO_SIMD) && defined(__AVX2__)
+#include <immintrin.h>
+#define GROUP_WIDTH 32
+#define USE_AVX2
+#elif !defined(HTUI32_SWISS_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define GROUP_WIDTH 16
+#define USE_SSE2
+#else
+#define GROUP_WIDTH 16
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define CTRL_EMPTY ((uint8_t)0x80)
+#define CTRL_DELETED ((uint8_t)0xFE)
+
+// Bit i of the mask corresponds to the control byte i of the group
+typedef uint32_t group_mask_t;
+
+static inline uint32_t trailing_zeros(group_mask_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+// Mask of control bytes equal to value
+static inline group_mask_t group_match(const uint8_t* group, uint8_t value)
+{
+#if defined(USE_AVX2)
+    __m256i ctrl = _mm256_loadu_si256((const __m256i*)group);
+    return (group_mask_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(ctrl, _mm256_set1_epi8((char)value)));
+#elif defined(USE_SSE2)
+    __m128i ctrl = _mm_loadu_si128((const __m128i*)group);
+    return (group_mask_t)_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)value)));
+#else
+    group_mask_t mask = 0;
+    for (uint32_t i = 0; i < GROUP_WIDTH; ++i) {
+        if (group[i] == value) {
+            mask |= (group_mask_t)1 << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+// Mask of EMPTY and DELETED control bytes, both have the high bit set
+static inline group_mask_t group_match_free(const uint8_t* group)
+{
+#if defined(USE_AVX2)
+    return (group_mask_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i*)group));
+#elif defined(USE_SSE2)
+    return (group_mask_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i*)group));
+#else
+    group_mask_t mask = 0;
+    for (uint32_t i = 0; i < GROUP_WIDTH; ++i) {
+        if (group[i] & 0x80) {
+            mask |= (group_mask_t)1 << i;
+        }
+    }
+    return mask;
+#endif
+}
+
+static inline uint8_t hash_h2(uint32_t hash)
+{
+    return (uint8_t)(hash & 0x7F);
+}
+
+static inline size_t hash_h1_group(uint32_t hash, size_t groups_count)
+{
+    return (hash >> 7) & (groups_count - 1);
+}
+
+/*
+ * Returns the position of the first free slot in the probe sequence of the hash
+ * There must be at least one free slot
+ */
+static size_t find_free_pos(uint8_t* ctrl, size_t capacity, uint32_t hash)
+{
+    size_t groups_count = capacity / GROUP_WIDTH;
+    size_t group = hash_h1_group(hash, groups_count);
+    for (size_t i = 0; ; ++i) {
+        group_mask_t mask = group_match_free(ctrl + group * GROUP_WIDTH);
+        if (mask != 0) {
+            return group * GROUP_WIDTH + trailing_zeros(mask);
+        }
+        group = (group + i + 1) & (groups_count - 1);
+    }
+}
+
+/*
+ * Searches for the key and returns its slot position in pos_ptr
+ * free_pos_ptr gets the first free slot of the groups probed on the way, which is where find_free_pos would put the key,
+ * or SIZE_MAX if there is none (free_pos_ptr can be NULL)
+ * Returns true if the key is found, otherwise false
+ */
+static bool find_pos(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, size_t* pos_ptr, size_t* free_pos_ptr)
+{
+    if (free_pos_ptr != NULL) {
+        *free_pos_ptr = SIZE_MAX;
+    }
+    uint8_t h2 = hash_h2(hash);
+    size_t groups_count = ht_ptr->capacity / GROUP_WIDTH;
+    size_t group = hash_h1_group(hash, groups_count);
+    HTUI32_COUNT(ht_ptr, lookups_count, 1);
+    for (size_t i = 0; i < groups_count; ++i) {
+        HTUI32_COUNT(ht_ptr, probe_steps_count, 1);
+        const uint8_t* group_ctrl = ht_ptr->ctrl_ptr + group * GROUP_WIDTH;
+        group_mask_t mask = group_match(group_ctrl, h2);
+        while (mask != 0) {
+            size_t pos = group * GROUP_WIDTH + trailing_zeros(mask);
+            if (ht_ptr->slots_ptr[pos].key == key) {
+                *pos_ptr = pos;
+                return true;
+            }
+            mask &= mask - 1;
+        }
+        if (free_pos_ptr != NULL && *free_pos_ptr == SIZE_MAX) {
+            group_mask_t free_mask = group_match_free(group_ctrl);
+            if (free_mask != 0) {
+                *free_pos_ptr = group * GROUP_WIDTH + trailing_zeros(free_mask);
+            }
+        }
+        // The key was never placed after a group with an empty slot
+        if (group_match(group_ctrl, CTRL_EMPTY) != 0) {
+            return false;
+        }
+        group = (group + i + 1) & (groups_count - 1);
+    }
+    return false;
+}
+
+size_t htui32_swiss_round_capacity(size_t capacity)
+{
+    size_t rounded = GROUP_WIDTH;
+    while (rounded < capacity) {
+        rounded *= 2;
+    }
+    return rounded;
+}
+
+uint32_t* htui32_swiss_find(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    size_t pos = 0;
+    if (find_pos(ht_ptr, key, hash, &pos, NULL)) {
+        return &ht_ptr->slots_ptr[pos].value;
+    }
+    return NULL;
+}
+
+/*
+ * Makes sure there is a slot for a new key, the DELETED slots are dropped first if they take up too much space (the keys move then)
+ * Returns false if there is no slot
+ */
+static bool make_room(hash_table_uint32_t* ht_ptr)
+{
+    size_t used_slots = ht_ptr->size - (ht_ptr->zero_key_is_used ? 1 : 0);
+    // DELETED slots also lengthen the probe sequences, get rid of them before they take up all the free space
+    if (ht_ptr->deleted_count != 0 && used_slots + ht_ptr->deleted_count + 1 >= ht_ptr->rehash_max_size) {
+        htui32_swiss_rehash(ht_ptr, ht_ptr->capacity);
+    }
+    // At least one slot must stay EMPTY, otherwise a lookup of a missing key probes every group
+    return used_slots + ht_ptr->deleted_count + 1 < ht_ptr->capacity;
+}
+
+// Puts the new key to the free slot pos
+static void place_key(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, size_t pos)
+{
+    if (ht_ptr->ctrl_ptr[pos] == CTRL_DELETED) {
+        ht_ptr->deleted_count--;
+    }
+    ht_ptr->ctrl_ptr[pos] = hash_h2(hash);
+    ht_ptr->slots_ptr[pos].key = key;
+    ht_ptr->slots_ptr[pos].value = value;
+}
+
+bool htui32_swiss_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value)
+{
+    if (!make_room(ht_ptr)) {
+        return false;
+    }
+    place_key(ht_ptr, key, hash, value, find_free_pos(ht_ptr->ctrl_ptr, ht_ptr->capacity, hash));
+    return true;
+}
+
+uint32_t* htui32_swiss_find_or_insert(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash, uint32_t value, bool* is_inserted_ptr)
+{
+    size_t pos = 0;
+    size_t free_pos = SIZE_MAX;
+    if (find_pos(ht_ptr, key, hash, &pos, &free_pos)) {
+        return &ht_ptr->slots_ptr[pos].value;
+    }
+    size_t deleted_count = ht_ptr->deleted_count;
+    if (!make_room(ht_ptr)) {
+        return NULL;
+    }
+    // The free slot found by the search is still the right one unless the DELETED slots were dropped
+    if (free_pos == SIZE_MAX || ht_ptr->deleted_count != deleted_count) {
+        free_pos = find_free_pos(ht_ptr->ctrl_ptr, ht_ptr->capacity, hash);
+    }
+    place_key(ht_ptr, key, hash, value, free_pos);
+    *is_inserted_ptr = true;
+    return &ht_ptr->slots_ptr[free_pos].value;
+}
+
+bool htui32_swiss_remove(hash_table_uint32_t* ht_ptr, uint32_t key, uint32_t hash)
+{
+    size_t pos = 0;
+    if (!find_pos(ht_ptr, key, hash, &pos, NULL)) {
+        return false;
+    }
+    // If the group already has an EMPTY slot, lookups stop in it anyway and the slot can become EMPTY,
+    // otherwise it must stay DELETED so that lookups continue to the next groups
+    const uint8_t* group_ctrl = ht_ptr->ctrl_ptr + (pos / GROUP_WIDTH) * GROUP_WIDTH;
+    if (group_match(group_ctrl, CTRL_EMPTY) != 0) {
+        ht_ptr->ctrl_ptr[pos] = CTRL_EMPTY;
+    }
+    else {
+        ht_ptr->ctrl_ptr[pos] = CTRL_DELETED;
+        ht_ptr->deleted_count++;
+    }
+    ht_ptr->slots_ptr[pos].key = 0;
+    ht_ptr->slots_ptr[pos].value = 0;
+    return true;
+}
+
+size_t htui32_swiss_probe_length(hash_table_uint32_t* ht_ptr, size_t pos)
+{
+    size_t groups_count = ht_ptr->capacity / GROUP_WIDTH;
+    size_t group = hash_h1_group(htui32_hash(ht_ptr->slots_ptr[pos].key), groups_count);
+    size_t length = 1;
+    while (group != pos / GROUP_WIDTH) {
+        group = (group + length) & (groups_count - 1);
+        length++;
+    }
+    return length;
+}
+
+bool htui32_swiss_slot_is_used(hash_table_uint32_t* ht_ptr, size_t pos)
+{
+    return (ht_ptr->ctrl_ptr[pos] & 0x80) == 0;
+}
+
+void htui32_swiss_prefetch(hash_table_uint32_t* ht_ptr, uint32_t hash)
+{
+    size_t group = hash_h1_group(hash, ht_ptr->capacity / GROUP_WIDTH);
+    htui32_prefetch(ht_ptr->ctrl_ptr + group * GROUP_WIDTH);
+    htui32_prefetch(ht_ptr->slots_ptr + group * GROUP_WIDTH);
+}
+
+/*
+ * Rehashes the keys within their own slots, so that there are no DELETED slots left
+ * Every used slot is marked DELETED first, the DELETED slots become EMPTY, then the marked keys are placed one by one
+ * to the first free slot of their probe sequence: a key stays if that slot is in its own group, it moves if the slot is EMPTY,
+ * and it is swapped with the marked key in the slot otherwise, which is placed next
+ */
+static void drop_deleted(hash_table_uint32_t* ht_ptr)
+{
+    uint8_t* ctrl = ht_ptr->ctrl_ptr;
+    hash_table_uint32_slot_t* slots = ht_ptr->slots_ptr;
+    size_t capacity = ht_ptr->capacity;
+    for (size_t i = 0; i < capacity; ++i) {
+        ctrl[i] = (ctrl[i] & 0x80) ? CTRL_EMPTY : CTRL_DELETED;
+    }
+    for (size_t i = 0; i < capacity; ++i) {
+        while (ctrl[i] == CTRL_DELETED) {
+            uint32_t hash = htui32_hash(slots[i].key);
+            size_t pos = find_free_pos(ctrl, capacity, hash);
+            if (pos / GROUP_WIDTH == i / GROUP_WIDTH) {
+                ctrl[i] = hash_h2(hash);
+            }
+            else if (ctrl[pos] == CTRL_EMPTY) {
+                ctrl[pos] = hash_h2(hash);
+                slots[pos] = slots[i];
+                ctrl[i] = CTRL_EMPTY;
+                slots[i].key = 0;
+                slots[i].value = 0;
+            }
+            else {
+                hash_table_uint32_slot_t marked = slots[pos];
+                ctrl[pos] = hash_h2(hash);
+                slots[pos] = slots[i];
+                slots[i] = marked;
+            }
+        }
+    }
+    ht_ptr->deleted_count = 0;
+}
+
+void htui32_swiss_attach(hash_table_uint32_t* ht_ptr, void* memory, size_t capacity)
+{
+    ht_ptr->slots_ptr = memory;
+    ht_ptr->ctrl_ptr = (uint8_t*)(ht_ptr->slots_ptr + capacity);
+    ht_ptr->capacity = capacity;
+    ht_ptr->memory_size = capacity * (sizeof(hash_table_uint32_slot_t) + 1);
+    ht_ptr->deleted_count = 0;
+    memset(ht_ptr->slots_ptr, 0, capacity * sizeof(hash_table_uint32_slot_t));
+    memset(ht_ptr->ctrl_ptr, CTRL_EMPTY, capacity);
+}
+
+bool htui32_swiss_rehash(hash_table_uint32_t* ht_ptr, size_t new_capacity)
+{
+    new_capacity = htui32_swiss_round_capacity(new_capacity);
+    if (new_capacity == ht_ptr->capacity && ht_ptr->slots_ptr != NULL) {
+        drop_deleted(ht_ptr);
+        return true;
+    }
+    size_t used_slots = ht_ptr->size - (ht_ptr->zero_key_is_used ? 1 : 0);
+    if (used_slots >= new_capacity) {
+        return false;
+    }
+    // Slots and control bytes share one allocation
+    size_t new_memory_size = new_capacity * (sizeof(hash_table_uint32_slot_t) + 1);
+    hash_table_uint32_slot_t* new_slots = alloc_func(ht_ptr, new_memory_size);
+    if (new_slots == NULL) {
+        return false;
+    }
+    uint8_t* new_ctrl = (uint8_t*)(new_slots + new_capacity);
+    memset(new_slots, 0, new_capacity * sizeof(hash_table_uint32_slot_t));
+    memset(new_ctrl, CTRL_EMPTY, new_capacity);
+    // Copy items to new slots, keys are unique so they are placed without lookup
+    for (size_t i = 0; i < ht_ptr->capacity; ++i) {
+        if ((ht_ptr->ctrl_ptr[i] & 0x80) == 0) {
+            uint32_t hash = htui32_hash(ht_ptr->slots_ptr[i].key);
+            size_t pos = find_free_pos(new_ctrl, new_capacity, hash);
+            new_ctrl[pos] = hash_h2(hash);
+            new_slots[pos] = ht_ptr->slots_ptr[i];
+        }
+    }
+    if (ht_ptr->slots_ptr != NULL) {
+        free_func(ht_ptr, ht_ptr->slots_ptr, ht_ptr->memory_size);
+    }
+    ht_ptr->slots_ptr = new_slots;
+    ht_ptr->ctrl_ptr = new_ctrl;
+    ht_ptr->capacity = new_capacity;
+    ht_ptr->memory_size = new_memory_size;
+    ht_ptr->deleted_count = 0;
+    return true;
+}
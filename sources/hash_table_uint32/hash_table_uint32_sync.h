@@ -0,0 +1,54 @@
+#ifndef _HASH_TABLE_UINT32_SYNC_
+#define _HASH_TABLE_UINT32_SYNC_
+
+/*
+ * Synchronization primitives of the concurrent table: SRW locks on Windows, POSIX read-write locks elsewhere.
+ * It is not a part of the public interface.
+ * On POSIX systems the including file must define _POSIX_C_SOURCE before any system header.
+ */
+
+#include "hash_table_uint32_atomic.h"
+
+// Storage class of thread-local variables
+#if defined(_MSC_VER)
+#define HTUI32_THREAD_LOCAL __declspec(thread)
+#else
+#define HTUI32_THREAD_LOCAL _Thread_local
+#endif
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+// Gives the processor to another thread while waiting
+static inline void htui32_yield(void) { SwitchToThread(); }
+
+typedef SRWLOCK htui32_rwlock_t;
+
+static inline void htui32_rwlock_init(htui32_rwlock_t* lock_ptr) { InitializeSRWLock(lock_ptr); }
+static inline void htui32_rwlock_destroy(htui32_rwlock_t* lock_ptr) { (void)lock_ptr; }
+static inline void htui32_rwlock_read_lock(htui32_rwlock_t* lock_ptr) { AcquireSRWLockShared(lock_ptr); }
+static inline void htui32_rwlock_read_unlock(htui32_rwlock_t* lock_ptr) { ReleaseSRWLockShared(lock_ptr); }
+static inline void htui32_rwlock_write_lock(htui32_rwlock_t* lock_ptr) { AcquireSRWLockExclusive(lock_ptr); }
+static inline void htui32_rwlock_write_unlock(htui32_rwlock_t* lock_ptr) { ReleaseSRWLockExclusive(lock_ptr); }
+static inline bool htui32_rwlock_try_write_lock(htui32_rwlock_t* lock_ptr) { return TryAcquireSRWLockExclusive(lock_ptr) != 0; }
+
+#else
+#include <pthread.h>
+#include <sched.h>
+
+static inline void htui32_yield(void) { sched_yield(); }
+
+typedef pthread_rwlock_t htui32_rwlock_t;
+
+static inline void htui32_rwlock_init(htui32_rwlock_t* lock_ptr) { pthread_rwlock_init(lock_ptr, NULL); }
+static inline void htui32_rwlock_destroy(htui32_rwlock_t* lock_ptr) { pthread_rwlock_destroy(lock_ptr); }
+static inline void htui32_rwlock_read_lock(htui32_rwlock_t* lock_ptr) { pthread_rwlock_rdlock(lock_ptr); }
+static inline void htui32_rwlock_read_unlock(htui32_rwlock_t* lock_ptr) { pthread_rwlock_unlock(lock_ptr); }
+static inline void htui32_rwlock_write_lock(htui32_rwlock_t* lock_ptr) { pthread_rwlock_wrlock(lock_ptr); }
+static inline void htui32_rwlock_write_unlock(htui32_rwlock_t* lock_ptr) { pthread_rwlock_unlock(lock_ptr); }
+static inline bool htui32_rwlock_try_write_lock(htui32_rwlock_t* lock_ptr) { return pthread_rwlock_trywrlock(lock_ptr) == 0; }
+
+#endif
+
+#endif
@@ -5,6 +5,29 @@
 extern "C" { void test_put_and_get(); }
 extern "C" { void test_put_and_get_rehash(); }
 extern "C" { void test_delete(); }
+extern "C" { void test_open_addressing(); }
+extern "C" { void test_swiss(); }
+extern "C" { void test_incremental_rehash(); }
+extern "C" { void test_rehash_step_size(); }
+extern "C" { void test_rehash_relink(); }
+extern "C" { void test_allocator(); }
+extern "C" { void test_item_pool(); }
+extern "C" { void test_batch(); }
+extern "C" { void test_reduction(); }
+extern "C" { void test_stats(); }
+extern "C" { void test_reserve_and_build(); }
+extern "C" { void test_growth_policy(); }
+extern "C" { void test_snapshot(); }
+extern "C" { void test_frozen(); }
+extern "C" { void test_compact_chaining(); }
+extern "C" { void test_fixed(); }
+extern "C" { void test_upsert(); }
+extern "C" { void test_cuckoo(); }
+extern "C" { void test_iterator(); }
+extern "C" { void test_rehash_alloc_failure(); }
+void test_concurrent();
+void test_sharded();
+void test_template();
 
 int main(void)
 {
@@ -14,7 +37,86 @@ int main(void)
     test_put_and_get_rehash();
     printf("test_delete()\n");
     test_delete();
-    printf("test_random()\n");
-    test_random();
+    printf("test_open_addressing()\n");
+    test_open_addressing();
+    printf("test_swiss()\n");
+    test_swiss();
+    printf("test_incremental_rehash()\n");
+    test_incremental_rehash();
+    printf("test_rehash_step_size()\n");
+    test_rehash_step_size();
+    printf("test_rehash_relink()\n");
+    test_rehash_relink();
+    printf("test_allocator()\n");
+    test_allocator();
+    printf("test_item_pool()\n");
+    test_item_pool();
+    printf("test_batch()\n");
+    test_batch();
+    printf("test_reduction()\n");
+    test_reduction();
+    printf("test_stats()\n");
+    test_stats();
+    printf("test_reserve_and_build()\n");
+    test_reserve_and_build();
+    printf("test_growth_policy()\n");
+    test_growth_policy();
+    printf("test_snapshot()\n");
+    test_snapshot();
+    printf("test_frozen()\n");
+    test_frozen();
+    printf("test_compact_chaining()\n");
+    test_compact_chaining();
+    printf("test_fixed()\n");
+    test_fixed();
+    printf("test_upsert()\n");
+    test_upsert();
+    printf("test_cuckoo()\n");
+    test_cuckoo();
+    printf("test_iterator()\n");
+    test_iterator();
+    printf("test_rehash_alloc_failure()\n");
+    test_rehash_alloc_failure();
+    printf("test_concurrent()\n");
+    test_concurrent();
+    printf("test_sharded()\n");
+    test_sharded();
+    printf("test_template()\n");
+    test_template();
+    htui32_config_t config = {};
+    printf("test_random(HTUI32_MODE_CHAINING)\n");
+    config.mode = HTUI32_MODE_CHAINING;
+    test_random(config);
+    printf("test_random(HTUI32_MODE_CHAINING, incremental_rehash)\n");
+    config.incremental_rehash = true;
+    test_random(config);
+    config.incremental_rehash = false;
+    printf("test_random(HTUI32_MODE_LINEAR_PROBING)\n");
+    config.mode = HTUI32_MODE_LINEAR_PROBING;
+    test_random(config);
+    printf("test_random(HTUI32_MODE_ROBIN_HOOD)\n");
+    config.mode = HTUI32_MODE_ROBIN_HOOD;
+    test_random(config);
+    printf("test_random(HTUI32_MODE_SWISS)\n");
+    config.mode = HTUI32_MODE_SWISS;
+    test_random(config);
+    printf("test_random(HTUI32_MODE_COMPACT_CHAINING)\n");
+    config.mode = HTUI32_MODE_COMPACT_CHAINING;
+    test_random(config);
+    printf("test_random(HTUI32_MODE_CUCKOO)\n");
+    config.mode = HTUI32_MODE_CUCKOO;
+    test_random(config);
+    printf("test_random(HTUI32_MODE_CHAINING, HTUI32_REDUCTION_MASK)\n");
+    config.mode = HTUI32_MODE_CHAINING;
+    config.reduction = HTUI32_REDUCTION_MASK;
+    test_random(config);
+    printf("test_random(HTUI32_MODE_LINEAR_PROBING, HTUI32_REDUCTION_FASTRANGE)\n");
+    config.mode = HTUI32_MODE_LINEAR_PROBING;
+    config.reduction = HTUI32_REDUCTION_FASTRANGE;
+    test_random(config);
+    printf("test_random(HTUI32_MODE_ROBIN_HOOD, HTUI32_REDUCTION_MASK)\n");
+    config.mode = HTUI32_MODE_ROBIN_HOOD;
+    config.reduction = HTUI32_REDUCTION_MASK;
+    test_random(config);
     return 0;
 }
@@ -0,0 +1,247 @@
+#include <cstdio>
+#include <cstdint>
+#include <cassert>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <vector>
+extern "C" {
+#include "../hash_table_uint32/hash_table_uint32_concurrent.h"
+}
+
+static const uint32_t threads_count = 4;
+static const uint32_t thread_keys_count = 20000;
+static const uint32_t stable_keys_count = 1000;
+static const uint32_t rounds_count = 4;
+
+// Keys of the thread are page aligned and do not intersect with the keys of the other threads
+static uint32_t thread_key(uint32_t thread_index, uint32_t i)
+{
+    return (thread_index * thread_keys_count + i + 1) * 4096;
+}
+
+// Stable keys are never deleted, so they must be found at any moment
+static uint32_t stable_key(uint32_t i)
+{
+    return i * 2 + 1;
+}
+
+static void writer(htui32_concurrent_t* ht_ptr, uint32_t thread_index)
+{
+    for (uint32_t round = 0; round < rounds_count; ++round) {
+        // The table grows while the keys are put
+        for (uint32_t i = 0; i < thread_keys_count; ++i) {
+            htui32_concurrent_put(ht_ptr, thread_key(thread_index, i), i + round);
+        }
+        for (uint32_t i = 0; i < thread_keys_count; ++i) {
+            uint32_t value = 0;
+            bool has_found = htui32_concurrent_get(ht_ptr, thread_key(thread_index, i), &value);
+            assert(has_found == true);
+            assert(value == i + round);
+        }
+        // And shrinks while they are deleted, except the last round
+        uint32_t step = (round + 1 == rounds_count) ? 2 : 1;
+        for (uint32_t i = 0; i < thread_keys_count; i += step) {
+            htui32_concurrent_delete(ht_ptr, thread_key(thread_index, i));
+        }
+        for (uint32_t i = 0; i < thread_keys_count; ++i) {
+            bool has_found = htui32_concurrent_get(ht_ptr, thread_key(thread_index, i), NULL);
+            assert(has_found == (i % step != 0));
+        }
+    }
+}
+
+static void reader(htui32_concurrent_t* ht_ptr, std::atomic<bool>* stop_ptr)
+{
+    while (!stop_ptr->load()) {
+        for (uint32_t i = 0; i < stable_keys_count; ++i) {
+            uint32_t value = 0;
+            bool has_found = htui32_concurrent_get(ht_ptr, stable_key(i), &value);
+            assert(has_found == true);
+            assert(value == i);
+        }
+    }
+}
+
+static void test_concurrent_config(bool read_mostly)
+{
+    htui32_concurrent_t ht;
+    htui32_concurrent_config_t config = {};
+    config.capacity = 4;
+    config.stripes_count = 4;
+    config.read_mostly = read_mostly;
+    htui32_concurrent_init(&ht, &config);
+    assert((ht.reader_slots_ptr != NULL) == read_mostly);
+    assert(ht.stripes_ptr != NULL);
+    assert(ht.stripes_count == 4);
+    assert(ht.capacity == 4);
+
+    // Single thread
+    uint32_t value = 0;
+    bool is_put = htui32_concurrent_put(&ht, 0, 999);
+    assert(is_put == true);
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        is_put = htui32_concurrent_put(&ht, i * 4096, i);
+        assert(is_put == true);
+    }
+    assert(htui32_concurrent_size(&ht) == 1001);
+    assert(ht.capacity > 1001);
+    assert(htui32_concurrent_get(&ht, 0, &value) == true);
+    assert(value == 999);
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        assert(htui32_concurrent_get(&ht, i * 4096, &value) == true);
+        assert(value == i);
+    }
+    assert(htui32_concurrent_get(&ht, 1001 * 4096, NULL) == false);
+    is_put = htui32_concurrent_put(&ht, 4096, 1000);
+    assert(is_put == true);
+    assert(htui32_concurrent_size(&ht) == 1001);
+    assert(htui32_concurrent_get(&ht, 4096, &value) == true);
+    assert(value == 1000);
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        htui32_concurrent_delete(&ht, i * 4096);
+    }
+    htui32_concurrent_delete(&ht, 0);
+    assert(htui32_concurrent_size(&ht) == 0);
+    assert(htui32_concurrent_get(&ht, 0, NULL) == false);
+    assert(ht.capacity == 4);
+
+    // Writers grow and shrink the table while the reader checks the keys that never change
+    for (uint32_t i = 0; i < stable_keys_count; ++i) {
+        htui32_concurrent_put(&ht, stable_key(i), i);
+    }
+    std::atomic<bool> stop(false);
+    std::thread reader_thread(reader, &ht, &stop);
+    std::vector<std::thread> writer_threads;
+    for (uint32_t t = 0; t < threads_count; ++t) {
+        writer_threads.emplace_back(writer, &ht, t);
+    }
+    for (std::thread& thread : writer_threads) {
+        thread.join();
+    }
+    stop.store(true);
+    reader_thread.join();
+    assert(htui32_concurrent_size(&ht) == stable_keys_count + threads_count * thread_keys_count / 2);
+
+    htui32_concurrent_destroy(&ht);
+    assert(ht.stripes_ptr == NULL);
+}
+
+// Grows the table from its initial capacity and shrinks it back, so resizes follow each other without a pause
+static void resizer(htui32_concurrent_t* ht_ptr, std::atomic<bool>* stop_ptr)
+{
+    for (uint32_t round = 0; round < 200; ++round) {
+        for (uint32_t i = 0; i < 2000; ++i) {
+            htui32_concurrent_put(ht_ptr, thread_key(0, i), i);
+        }
+        for (uint32_t i = 0; i < 2000; ++i) {
+            htui32_concurrent_delete(ht_ptr, thread_key(0, i));
+        }
+    }
+    stop_ptr->store(true);
+}
+
+// Lockless gets of several threads while the table is resized back to back, a get that started in one epoch
+// and was counted after the next resizing must still hold off freeing the buckets it reads
+static void test_concurrent_resize_stress()
+{
+    htui32_concurrent_t ht;
+    htui32_concurrent_config_t config = {};
+    config.capacity = 4;
+    config.stripes_count = 4;
+    config.read_mostly = true;
+    htui32_concurrent_init(&ht, &config);
+    for (uint32_t i = 0; i < 16; ++i) {
+        htui32_concurrent_put(&ht, stable_key(i), i);
+    }
+    std::atomic<bool> stop(false);
+    std::vector<std::thread> reader_threads;
+    for (uint32_t t = 0; t < threads_count; ++t) {
+        reader_threads.emplace_back([&ht, &stop]() {
+            while (!stop.load()) {
+                for (uint32_t i = 0; i < 16; ++i) {
+                    uint32_t value = 0;
+                    bool has_found = htui32_concurrent_get(&ht, stable_key(i), &value);
+                    assert(has_found == true);
+                    assert(value == i);
+                }
+            }
+        });
+    }
+    std::thread resizer_thread(resizer, &ht, &stop);
+    resizer_thread.join();
+    for (std::thread& thread : reader_threads) {
+        thread.join();
+    }
+    assert(htui32_concurrent_size(&ht) == 16);
+    htui32_concurrent_destroy(&ht);
+}
+
+struct failing_allocator_context_t {
+    bool fail;
+};
+
+static void* failing_alloc(void* context, size_t size)
+{
+    return static_cast<failing_allocator_context_t*>(context)->fail ? NULL : malloc(size);
+}
+
+static void failing_free(void* context, void* ptr, size_t size)
+{
+    (void)context;
+    (void)size;
+    free(ptr);
+}
+
+// A put of a new key that cannot allocate its item reports it, the key is not in the table then
+static void test_concurrent_alloc_failure()
+{
+    failing_allocator_context_t allocator_context = { false };
+    htui32_allocator_t allocator = { failing_alloc, failing_free, &allocator_context };
+    htui32_concurrent_t ht;
+    htui32_concurrent_config_t config = {};
+    config.capacity = 4;
+    config.stripes_count = 4;
+    config.allocator = &allocator;
+    htui32_concurrent_init(&ht, &config);
+    bool is_put = htui32_concurrent_put(&ht, 4096, 1);
+    assert(is_put == true);
+
+    // The items left in the pool blocks are used first, a put fails when a new block is needed
+    allocator_context.fail = true;
+    uint32_t failed_key = 0;
+    for (uint32_t i = 2; i <= 100000 && failed_key == 0; ++i) {
+        if (!htui32_concurrent_put(&ht, i * 4096, i)) {
+            failed_key = i * 4096;
+        }
+    }
+    assert(failed_key != 0);
+    size_t size = htui32_concurrent_size(&ht);
+    assert(htui32_concurrent_get(&ht, failed_key, NULL) == false);
+    assert(size == failed_key / 4096 - 1);
+    // Existing keys are updated without memory
+    uint32_t value = 0;
+    is_put = htui32_concurrent_put(&ht, 4096, 2);
+    assert(is_put == true);
+    assert(htui32_concurrent_get(&ht, 4096, &value) == true);
+    assert(value == 2);
+    is_put = htui32_concurrent_put(&ht, 0, 3);
+    assert(is_put == true);
+    assert(htui32_concurrent_size(&ht) == size + 1);
+
+    allocator_context.fail = false;
+    is_put = htui32_concurrent_put(&ht, failed_key, 4);
+    assert(is_put == true);
+    assert(htui32_concurrent_get(&ht, failed_key, &value) == true);
+    assert(value == 4);
+    htui32_concurrent_destroy(&ht);
+}
+
+void test_concurrent()
+{
+    test_concurrent_config(false);
+    // Lockless gets
+    test_concurrent_config(true);
+    test_concurrent_resize_stress();
+    test_concurrent_alloc_failure();
+}
@@ -9,7 +9,7 @@
 #include <random>
 #include <exception>
 #include <cassert>
-#include "../hash_table_uint32/hash_table_uint32_cpp.h"
+#include "../hash_table_uint32/hash_table_uint32.h"
 
 std::random_device r_dev;
 const uint32_t seed = r_dev();
@@ -180,7 +180,11 @@ void do_action(hash_table_uint32_t* ht_ptr)
     action_counter++;
 }
 
-void test_random()
+/*
+ * Runs random actions on tables created with the config
+ * The capacity of the config is chosen randomly for each iteration
+ */
+void test_random(htui32_config_t config)
 {
     r_dist = std::uniform_int_distribution<uint32_t>(iterations_min_number, iterations_max_number);
     uint32_t iterations_number = r_dist(r_engine);
@@ -197,7 +201,8 @@ void test_random()
         uint32_t actions_number = r_dist(r_engine);
         //printf("Actions number: %u\n", actions_number);
 
-        htui32_init(&ht, initial_capacity, 0, 0);
+        config.capacity = initial_capacity;
+        htui32_init_ex(&ht, &config);
 
         for (uint32_t i = 0; i < actions_number; ++i) {
             do_action(&ht);
@@ -0,0 +1,163 @@
+#include <cstdio>
+#include <cstdint>
+#include <cassert>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "../hash_table_uint32/hash_table_uint32_sharded.h"
+
+static const uint32_t threads_count = 4;
+static const uint32_t thread_keys_count = 20000;
+
+// Keys of the thread are page aligned and do not intersect with the keys of the other threads
+static uint32_t thread_key(uint32_t thread_index, uint32_t i)
+{
+    return (thread_index * thread_keys_count + i + 1) * 4096;
+}
+
+static void writer(htui32_sharded_t* ht_ptr, uint32_t thread_index)
+{
+    for (uint32_t i = 0; i < thread_keys_count; ++i) {
+        htui32_sharded_put(ht_ptr, thread_key(thread_index, i), i);
+    }
+    for (uint32_t i = 0; i < thread_keys_count; ++i) {
+        uint32_t value = 0;
+        bool has_found = htui32_sharded_get(ht_ptr, thread_key(thread_index, i), &value);
+        assert(has_found == true);
+        assert(value == i);
+    }
+    for (uint32_t i = 0; i < thread_keys_count; i += 2) {
+        htui32_sharded_delete(ht_ptr, thread_key(thread_index, i));
+    }
+}
+
+// The thread owns the shards whose index modulo the number of threads is its index and uses only their keys
+static void affine_writer(htui32_sharded_t* ht_ptr, uint32_t thread_index, const std::vector<uint32_t>* keys_ptr)
+{
+    size_t count = 0;
+    for (uint32_t key : *keys_ptr) {
+        if (htui32_sharded_shard_of(ht_ptr, key) % threads_count == thread_index) {
+            htui32_sharded_put(ht_ptr, key, key / 4096);
+            ++count;
+        }
+    }
+    for (uint32_t key : *keys_ptr) {
+        if (htui32_sharded_shard_of(ht_ptr, key) % threads_count == thread_index) {
+            uint32_t value = 0;
+            bool has_found = htui32_sharded_get(ht_ptr, key, &value);
+            assert(has_found == true);
+            assert(value == key / 4096);
+        }
+    }
+    assert(count != 0);
+}
+
+static void test_sharded_config(bool thread_affine)
+{
+    htui32_sharded_t ht;
+    htui32_sharded_config_t config;
+    memset(&config, 0, sizeof(config));
+    // Rounded up to 8
+    config.shards_count = 6;
+    config.thread_affine = thread_affine;
+    config.shard_config.capacity = 4;
+    config.shard_config.reduction = HTUI32_REDUCTION_FASTRANGE;
+    htui32_sharded_init(&ht, &config);
+    assert(ht.shards_ptr != NULL);
+    assert(ht.shards_count == 8);
+    assert(ht.shard_bits == 3);
+
+    // Single thread
+    uint32_t value = 0;
+    htui32_sharded_put(&ht, 0, 999);
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        htui32_sharded_put(&ht, i * 4096, i);
+    }
+    assert(htui32_sharded_size(&ht) == 1001);
+    assert(htui32_sharded_get(&ht, 0, &value) == true);
+    assert(value == 999);
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        assert(htui32_sharded_get(&ht, i * 4096, &value) == true);
+        assert(value == i);
+    }
+    assert(htui32_sharded_get(&ht, 1001 * 4096, NULL) == false);
+
+    // Every shard gets some of the keys and the statistics add them up
+    htui32_stats_t stats;
+    htui32_sharded_stats(&ht, &stats);
+    assert(stats.size == 1001);
+    assert(stats.used_buckets + stats.overflow_items == 1000);
+    assert(stats.capacity > 1000);
+    assert(stats.max_chain_length >= 1);
+    for (size_t i = 0; i < ht.shards_count; ++i) {
+        bool has_key = false;
+        for (uint32_t j = 1; j <= 1000 && !has_key; ++j) {
+            has_key = htui32_sharded_shard_of(&ht, j * 4096) == i;
+        }
+        assert(has_key == true);
+    }
+
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        htui32_sharded_delete(&ht, i * 4096);
+    }
+    htui32_sharded_delete(&ht, 0);
+    assert(htui32_sharded_size(&ht) == 0);
+    assert(htui32_sharded_get(&ht, 0, NULL) == false);
+
+    std::vector<std::thread> threads;
+    if (thread_affine) {
+        std::vector<uint32_t> keys;
+        for (uint32_t i = 0; i < threads_count * thread_keys_count; ++i) {
+            keys.push_back((i + 1) * 4096);
+        }
+        for (uint32_t t = 0; t < threads_count; ++t) {
+            threads.emplace_back(affine_writer, &ht, t, &keys);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        assert(htui32_sharded_size(&ht) == keys.size());
+    }
+    else {
+        for (uint32_t t = 0; t < threads_count; ++t) {
+            threads.emplace_back(writer, &ht, t);
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        assert(htui32_sharded_size(&ht) == threads_count * thread_keys_count / 2);
+        for (uint32_t t = 0; t < threads_count; ++t) {
+            for (uint32_t i = 0; i < thread_keys_count; ++i) {
+                assert(htui32_sharded_get(&ht, thread_key(t, i), NULL) == (i % 2 != 0));
+            }
+        }
+    }
+
+    htui32_sharded_destroy(&ht);
+    assert(ht.shards_ptr == NULL);
+}
+
+void test_sharded()
+{
+    test_sharded_config(false);
+    // Unlocked shards, one thread per shard
+    test_sharded_config(true);
+
+    // A single shard is a plain table
+    htui32_sharded_t ht;
+    htui32_sharded_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.shards_count = 1;
+    htui32_sharded_init(&ht, &config);
+    assert(ht.shards_count == 1);
+    assert(ht.shard_bits == 0);
+    htui32_sharded_put(&ht, 4096, 1);
+    assert(htui32_sharded_shard_of(&ht, 4096) == 0);
+    assert(htui32_sharded_get(&ht, 4096, NULL) == true);
+    htui32_sharded_destroy(&ht);
+
+    // Default number of shards
+    htui32_sharded_init(&ht, NULL);
+    assert(ht.shards_count == HTUI32_SHARDED_DEFAULT_SHARDS);
+    htui32_sharded_destroy(&ht);
+}
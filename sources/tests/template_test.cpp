@@ -0,0 +1,152 @@
+#include <cstdio>
+#include <cstdint>
+#include <cassert>
+#include <map>
+#include <string>
+#include <utility>
+#include "../hash_table_uint32/hash_table_uint32.hpp"
+
+template <typename Table>
+static void test_template_table()
+{
+    Table ht(4);
+    assert(ht.size() == 0);
+    assert(ht.capacity() == 4);
+    assert(ht.begin() == ht.end());
+
+    // The key 0 has its own slot
+    ht.put(0, 999);
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        ht.put(i * 4096, i);
+    }
+    assert(ht.size() == 1001);
+    assert(ht.capacity() > 1001);
+    uint32_t value = 0;
+    assert(ht.get(0, &value) == true);
+    assert(value == 999);
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        assert(ht.get(i * 4096, &value) == true);
+        assert(value == i);
+    }
+    assert(ht.get(1001 * 4096, NULL) == false);
+    ht.put(4096, 1000);
+    assert(ht.size() == 1001);
+    assert(*ht.find(4096) == 1000);
+    *ht.find(4096) = 1;
+
+    // Iterators visit every key once, the key 0 included
+    std::map<uint32_t, uint32_t> keys;
+    for (auto& slot : ht) {
+        assert(keys.count(slot.key) == 0);
+        keys[slot.key] = slot.value;
+    }
+    assert(keys.size() == 1001);
+    assert(keys[0] == 999);
+    assert(keys[4096] == 1);
+
+    // Moves keep the keys and leave the source empty
+    Table moved(std::move(ht));
+    assert(moved.size() == 1001);
+    assert(ht.size() == 0);
+    assert(ht.contains(4096) == false);
+    assert(moved.contains(4096) == true);
+    ht = std::move(moved);
+    assert(ht.size() == 1001);
+    assert(moved.size() == 0);
+    // A moved table can be used again
+    moved.put(1, 1);
+    assert(moved.contains(1) == true);
+
+    // Deletes shrink the table back
+    bool is_erased = false;
+    for (uint32_t i = 1; i <= 1000; i += 2) {
+        is_erased = ht.erase(i * 4096);
+        assert(is_erased == true);
+    }
+    is_erased = ht.erase(4096);
+    assert(is_erased == false);
+    assert(ht.size() == 501);
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        assert(ht.contains(i * 4096) == (i % 2 == 0));
+    }
+    for (uint32_t i = 2; i <= 1000; i += 2) {
+        is_erased = ht.erase(i * 4096);
+        assert(is_erased == true);
+    }
+    is_erased = ht.erase(0);
+    assert(is_erased == true);
+    assert(ht.size() == 0);
+    assert(ht.capacity() == 4);
+
+    ht.reserve(1000);
+    size_t capacity = ht.capacity();
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        ht.put(i, i);
+    }
+    assert(ht.capacity() == capacity);
+    ht.clear();
+    assert(ht.size() == 0);
+    assert(ht.capacity() == 4);
+}
+
+void test_template()
+{
+    test_template_table<htui32::HashTable<uint32_t, uint32_t> >();
+    test_template_table<htui32::HashTable<uint32_t, uint32_t, htui32::MultiplyShiftHash, htui32::ModuloReduction> >();
+    test_template_table<htui32::HashTable<uint32_t, uint32_t, htui32::Fmix32Hash, htui32::FastrangeReduction> >();
+    test_template_table<htui32::HashTable<uint64_t, uint32_t> >();
+
+    // 64-bit keys and values, the keys differ only in the high half
+    htui32::HashTableUInt64 ht64;
+    for (uint64_t i = 0; i < 10000; ++i) {
+        ht64.put(i << 32, ~i);
+    }
+    assert(ht64.size() == 10000);
+    for (uint64_t i = 0; i < 10000; ++i) {
+        uint64_t value = 0;
+        assert(ht64.get(i << 32, &value) == true);
+        assert(value == ~i);
+        assert(ht64.contains((i << 32) + 1) == false);
+    }
+
+    // Aligned addresses as keys, the null pointer is the key in the separate slot
+    static uint64_t objects[1000];
+    htui32::PointerMap<size_t> pointers;
+    pointers.put(NULL, 1000);
+    for (size_t i = 0; i < 1000; ++i) {
+        pointers.put(&objects[i], i);
+    }
+    assert(pointers.size() == 1001);
+    for (size_t i = 0; i < 1000; i += 2) {
+        pointers.erase(&objects[i]);
+    }
+    for (size_t i = 0; i < 1000; ++i) {
+        const size_t* value_ptr = pointers.find(&objects[i]);
+        assert((value_ptr != NULL) == (i % 2 == 1));
+        assert(value_ptr == NULL || *value_ptr == i);
+    }
+    assert(*pointers.find(NULL) == 1000);
+
+    // Values that are not trivially copyable
+    htui32::HashTable<uint64_t, std::string> strings;
+    for (uint64_t i = 0; i < 100; ++i) {
+        strings.put(i << 32, std::to_string(i));
+    }
+    for (uint64_t i = 0; i < 100; i += 2) {
+        strings.erase(i << 32);
+    }
+    for (uint64_t i = 0; i < 100; ++i) {
+        const std::string* value_ptr = strings.find(i << 32);
+        assert((value_ptr != NULL) == (i % 2 == 1));
+        if (value_ptr != NULL) {
+            assert(*value_ptr == std::to_string(i));
+        }
+    }
+    const htui32::HashTable<uint64_t, std::string>& const_strings = strings;
+    size_t count = 0;
+    for (htui32::HashTable<uint64_t, std::string>::const_iterator it = const_strings.begin(); it != const_strings.end(); ++it) {
+        assert(it->value == std::to_string(it->key >> 32));
+        count++;
+    }
+    assert(count == 50);
+}
@@ -1,9 +1,11 @@
 #include "tests.h"
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
 #include <stdio.h>
 #include "../hash_table_uint32/hash_table_uint32.h"
+#include "../hash_table_uint32/hash_table_uint32_hash.h"
 
 void test_put_and_get()
 {
@@ -309,3 +311,1734 @@ void test_delete()
 
     htui32_destroy(&ht);
 }
+
+void test_open_addressing()
+{
+    htui32_mode_t modes[] = { HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_ROBIN_HOOD };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        hash_table_uint32_t ht;
+        memset(&ht, 0, sizeof(ht));
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.capacity = 4;
+        config.mode = modes[m];
+        htui32_init_ex(&ht, &config);
+        assert(ht.mode == modes[m]);
+        assert(ht.memory_ptr == NULL);
+        assert(ht.slots_ptr != NULL);
+
+        uint32_t value = 0;
+        bool has_found = false;
+        // Zero key is stored in the side slot
+        htui32_put(&ht, 0, 999);
+        assert(ht.size == 1);
+        has_found = htui32_get(&ht, 0, &value);
+        assert(has_found == true);
+        assert(value == 999);
+
+        // Grow from 4 to 128
+        for (uint32_t i = 1; i <= 64; ++i) {
+            htui32_put(&ht, i * 4096, i);
+        }
+        assert(ht.size == 65);
+        assert(ht.capacity == 128);
+        assert(ht.memory_size == 128 * sizeof(hash_table_uint32_slot_t));
+        for (uint32_t i = 1; i <= 64; ++i) {
+            has_found = htui32_get(&ht, i * 4096, &value);
+            assert(has_found == true);
+            assert(value == i);
+        }
+        has_found = htui32_get(&ht, 65 * 4096, NULL);
+        assert(has_found == false);
+
+        // Overwrite
+        htui32_put(&ht, 4096, 1000);
+        assert(ht.size == 65);
+        has_found = htui32_get(&ht, 4096, &value);
+        assert(has_found == true);
+        assert(value == 1000);
+
+        // Delete every second key, the remaining keys must stay reachable after backward shifting
+        for (uint32_t i = 2; i <= 64; i += 2) {
+            htui32_delete(&ht, i * 4096);
+        }
+        assert(ht.size == 33);
+        for (uint32_t i = 1; i <= 64; ++i) {
+            has_found = htui32_get(&ht, i * 4096, &value);
+            assert(has_found == (i % 2 == 1));
+        }
+        has_found = htui32_get(&ht, 0, &value);
+        assert(has_found == true);
+        assert(value == 999);
+
+        // Shrink back to the initial capacity
+        for (uint32_t i = 1; i <= 64; i += 2) {
+            htui32_delete(&ht, i * 4096);
+        }
+        htui32_delete(&ht, 0);
+        assert(ht.size == 0);
+        assert(ht.capacity == 4);
+
+        htui32_destroy(&ht);
+    }
+}
+
+void test_swiss()
+{
+    hash_table_uint32_t ht;
+    memset(&ht, 0, sizeof(ht));
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.capacity = 4;
+    config.load_fac_min = 1;
+    config.mode = HTUI32_MODE_SWISS;
+    htui32_init_ex(&ht, &config);
+    // Capacity is rounded up to a power of two of whole groups
+    assert(ht.capacity >= 16);
+    assert((ht.capacity & (ht.capacity - 1)) == 0);
+    assert(ht.initial_capacity == ht.capacity);
+    size_t initial_capacity = ht.capacity;
+
+    uint32_t value = 0;
+    bool has_found = false;
+    htui32_put(&ht, 0, 999);
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        htui32_put(&ht, i * 4096, i);
+    }
+    assert(ht.size == 1001);
+    assert(ht.capacity == 2048);
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        has_found = htui32_get(&ht, i * 4096, &value);
+        assert(has_found == true);
+        assert(value == i);
+    }
+    has_found = htui32_get(&ht, 1001 * 4096, NULL);
+    assert(has_found == false);
+
+    // Insert and delete churn leaves DELETED control bytes, which must be reused or purged
+    for (uint32_t round = 0; round < 20; ++round) {
+        for (uint32_t i = 1; i <= 1000; i += 2) {
+            htui32_delete(&ht, i * 4096 + round);
+        }
+        for (uint32_t i = 1; i <= 1000; i += 2) {
+            htui32_put(&ht, i * 4096 + round + 1, i);
+        }
+        assert(ht.size == 1001);
+        assert(ht.capacity == 2048);
+    }
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        uint32_t key = (i % 2 == 1) ? i * 4096 + 20 : i * 4096;
+        has_found = htui32_get(&ht, key, &value);
+        assert(has_found == true);
+        assert(value == i);
+    }
+    has_found = htui32_get(&ht, 0, &value);
+    assert(has_found == true);
+    assert(value == 999);
+
+    // Shrink back to the initial capacity
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        uint32_t key = (i % 2 == 1) ? i * 4096 + 20 : i * 4096;
+        htui32_delete(&ht, key);
+    }
+    htui32_delete(&ht, 0);
+    assert(ht.size == 0);
+    has_found = htui32_get(&ht, 4096, NULL);
+    assert(has_found == false);
+
+    htui32_destroy(&ht);
+
+    // Without shrinking the capacity stays, but deleted slots do not fill the table
+    htui32_init_ex(&ht, &config);
+    for (uint32_t i = 1; i <= 100000; ++i) {
+        htui32_put(&ht, i, i);
+        htui32_delete(&ht, i);
+    }
+    assert(ht.size == 0);
+    assert(ht.capacity == initial_capacity);
+    htui32_destroy(&ht);
+}
+
+void test_incremental_rehash()
+{
+    hash_table_uint32_t ht;
+    memset(&ht, 0, sizeof(ht));
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.capacity = 4;
+    config.mode = HTUI32_MODE_CHAINING;
+    config.incremental_rehash = true;
+    htui32_init_ex(&ht, &config);
+
+    uint32_t value = 0;
+    bool has_found = false;
+    bool was_in_progress = false;
+    htui32_put(&ht, 0, 999);
+    for (uint32_t i = 1; i <= 4096; ++i) {
+        htui32_put(&ht, i * 4096, i);
+        was_in_progress = was_in_progress || ht.old_memory_ptr != NULL;
+        // Keys must be reachable in both memories while rehashing is in progress
+        if (i % 61 == 0) {
+            for (uint32_t j = 1; j <= i; ++j) {
+                has_found = htui32_get(&ht, j * 4096, &value);
+                assert(has_found == true);
+                assert(value == j);
+            }
+        }
+    }
+    assert(was_in_progress == true);
+    assert(ht.size == 4097);
+    assert(ht.capacity == 8192);
+    has_found = htui32_get(&ht, 0, &value);
+    assert(has_found == true);
+    assert(value == 999);
+
+    // Overwrite and delete while shrinking
+    was_in_progress = false;
+    for (uint32_t i = 1; i <= 4096; ++i) {
+        if (i % 2 == 0) {
+            htui32_put(&ht, i * 4096, i + 1);
+        }
+        else {
+            htui32_delete(&ht, i * 4096);
+        }
+    }
+    for (uint32_t i = 1; i <= 4096; i += 2) {
+        htui32_delete(&ht, (i + 1) * 4096);
+        was_in_progress = was_in_progress || ht.old_memory_ptr != NULL;
+        for (uint32_t j = i + 2; j <= 4096 && i % 127 == 1; j += 2) {
+            has_found = htui32_get(&ht, (j + 1) * 4096, &value);
+            assert(has_found == true);
+            assert(value == j + 2);
+        }
+    }
+    assert(was_in_progress == true);
+    assert(ht.size == 1);
+    htui32_delete(&ht, 0);
+    assert(ht.size == 0);
+    has_found = htui32_get(&ht, 4096, NULL);
+    assert(has_found == false);
+
+    htui32_destroy(&ht);
+}
+
+// Number of buckets of the incremental rehashing in progress that are cleared or moved
+static size_t rehash_progress(hash_table_uint32_t* ht_ptr)
+{
+    return (ht_ptr->old_memory_ptr != NULL) ? ht_ptr->cleared_count + ht_ptr->rehash_pos : 0;
+}
+
+/*
+ * Checks the buckets cleared or moved by one put or delete: the rehashing in progress is done by its steps
+ * and not at once by the next growth (shrinking), the rehashing started by the operation makes only its first step
+ * Returns the step size of the rehashing in progress after the operation (0 if there is none)
+ */
+static size_t check_rehash_work(hash_table_uint32_t* ht_ptr, bool was_in_progress, size_t progress, size_t buckets_count, size_t step, size_t capacity)
+{
+    if (was_in_progress) {
+        bool is_done = ht_ptr->old_memory_ptr == NULL || ht_ptr->capacity != capacity;
+        size_t work = (is_done ? buckets_count : rehash_progress(ht_ptr)) - progress;
+        assert(work <= step);
+    }
+    if (ht_ptr->old_memory_ptr == NULL) {
+        return 0;
+    }
+    if (ht_ptr->capacity != capacity) {
+        assert(rehash_progress(ht_ptr) <= ht_ptr->rehash_step);
+    }
+    return ht_ptr->rehash_step;
+}
+
+void test_rehash_step_size()
+{
+    hash_table_uint32_t ht;
+    memset(&ht, 0, sizeof(ht));
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.capacity = 64;
+    config.mode = HTUI32_MODE_CHAINING;
+    config.growth_fac = 110;
+    config.incremental_rehash = true;
+    htui32_init_ex(&ht, &config);
+    size_t min_step = ht.rehash_step;
+
+    // A growth by 10% leaves only a few puts until the next growth, the fixed step would not finish the rehashing by then
+    size_t max_step = 0;
+    size_t grow_count = 0;
+    for (uint32_t key = 1; key <= 20000; ++key) {
+        bool was_in_progress = ht.old_memory_ptr != NULL;
+        size_t progress = rehash_progress(&ht);
+        size_t buckets_count = ht.capacity + ht.old_capacity;
+        size_t step = ht.rehash_step;
+        size_t capacity = ht.capacity;
+        htui32_put(&ht, key, key + 1);
+        grow_count += (ht.capacity != capacity) ? 1 : 0;
+        step = check_rehash_work(&ht, was_in_progress, progress, buckets_count, step, capacity);
+        max_step = (step > max_step) ? step : max_step;
+    }
+    assert(grow_count > 50);
+    assert(max_step > min_step);
+    assert(max_step <= 32);
+    for (uint32_t key = 1; key <= 20000; key += 97) {
+        uint32_t value = 0;
+        assert(htui32_get(&ht, key, &value) == true);
+        assert(value == key + 1);
+    }
+
+    size_t shrink_count = 0;
+    for (uint32_t key = 1; key <= 20000; ++key) {
+        bool was_in_progress = ht.old_memory_ptr != NULL;
+        size_t progress = rehash_progress(&ht);
+        size_t buckets_count = ht.capacity + ht.old_capacity;
+        size_t step = ht.rehash_step;
+        size_t capacity = ht.capacity;
+        htui32_delete(&ht, key);
+        shrink_count += (ht.capacity != capacity) ? 1 : 0;
+        check_rehash_work(&ht, was_in_progress, progress, buckets_count, step, capacity);
+    }
+    assert(shrink_count > 0);
+    assert(ht.size == 0);
+
+    htui32_destroy(&ht);
+}
+
+// Collects the collision chain items of the table to items, returns the number of items
+static size_t collect_chain_items(hash_table_uint32_t* ht_ptr, hash_table_uint32_item_t** items, size_t max_count)
+{
+    size_t count = 0;
+    for (size_t i = 0; i < ht_ptr->capacity; ++i) {
+        for (hash_table_uint32_item_t* current_item = ht_ptr->memory_ptr[i].next; current_item != NULL; current_item = current_item->next) {
+            assert(count < max_count);
+            items[count++] = current_item;
+        }
+    }
+    return count;
+}
+
+void test_rehash_relink()
+{
+    hash_table_uint32_t ht;
+    memset(&ht, 0, sizeof(ht));
+    htui32_init(&ht, 64, 0, 100);
+
+    // 63 keys in 64 buckets give plenty of collision chain items
+    for (uint32_t i = 1; i <= 63; ++i) {
+        htui32_put(&ht, i, i);
+    }
+    assert(ht.capacity == 64);
+    hash_table_uint32_item_t* old_items[64];
+    size_t old_items_count = collect_chain_items(&ht, old_items, 64);
+    assert(old_items_count > 0);
+
+    // Rehash to 128 buckets, collision chain items must be relinked, not allocated again
+    htui32_put(&ht, 64, 64);
+    assert(ht.capacity == 128);
+    assert(ht.size == 64);
+    hash_table_uint32_item_t* new_items[64];
+    size_t new_items_count = collect_chain_items(&ht, new_items, 64);
+    for (size_t i = 0; i < new_items_count; ++i) {
+        bool is_old_item = false;
+        for (size_t j = 0; j < old_items_count; ++j) {
+            is_old_item = is_old_item || new_items[i] == old_items[j];
+        }
+        assert(is_old_item == true);
+    }
+    // Items left over by rehashing are released to the item pool
+    assert(new_items_count < old_items_count);
+    assert(ht.item_pool.free_items_ptr != NULL);
+
+    uint32_t value = 0;
+    for (uint32_t i = 1; i <= 64; ++i) {
+        bool has_found = htui32_get(&ht, i, &value);
+        assert(has_found == true);
+        assert(value == i);
+    }
+
+    htui32_destroy(&ht);
+}
+
+typedef struct {
+    size_t alloc_count;
+    size_t free_count;
+    size_t allocated_bytes;
+} counting_allocator_context_t;
+
+static void* counting_alloc(void* context, size_t size)
+{
+    counting_allocator_context_t* counters = context;
+    counters->alloc_count++;
+    counters->allocated_bytes += size;
+    return malloc(size);
+}
+
+static void counting_free(void* context, void* ptr, size_t size)
+{
+    counting_allocator_context_t* counters = context;
+    counters->free_count++;
+    assert(counters->allocated_bytes >= size);
+    counters->allocated_bytes -= size;
+    free(ptr);
+}
+
+void test_allocator()
+{
+    // The last chaining pass uses incremental rehashing
+    htui32_mode_t modes[] = { HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_ROBIN_HOOD, HTUI32_MODE_SWISS, HTUI32_MODE_CHAINING, HTUI32_MODE_CHAINING };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        counting_allocator_context_t counters;
+        memset(&counters, 0, sizeof(counters));
+        htui32_allocator_t allocator;
+        allocator.alloc = counting_alloc;
+        allocator.free = counting_free;
+        allocator.context = &counters;
+
+        hash_table_uint32_t ht;
+        memset(&ht, 0, sizeof(ht));
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.mode = modes[m];
+        config.incremental_rehash = (m == sizeof(modes) / sizeof(modes[0]) - 1);
+        config.allocator = &allocator;
+        htui32_init_ex(&ht, &config);
+        assert(counters.alloc_count == 1);
+        assert(counters.allocated_bytes == ht.memory_size);
+
+        for (uint32_t i = 0; i < 1000; ++i) {
+            htui32_put(&ht, i * 4096, i);
+        }
+        for (uint32_t i = 0; i < 1000; i += 3) {
+            htui32_delete(&ht, i * 4096);
+        }
+        assert(counters.alloc_count > 1);
+        assert(counters.allocated_bytes >= ht.memory_size);
+
+        // Sizes passed to free match the allocated sizes, so nothing is left after destroy
+        htui32_destroy(&ht);
+        assert(counters.free_count == counters.alloc_count);
+        assert(counters.allocated_bytes == 0);
+    }
+}
+
+void test_item_pool()
+{
+    counting_allocator_context_t counters;
+    memset(&counters, 0, sizeof(counters));
+    htui32_allocator_t allocator;
+    allocator.alloc = counting_alloc;
+    allocator.free = counting_free;
+    allocator.context = &counters;
+
+    hash_table_uint32_t ht;
+    memset(&ht, 0, sizeof(ht));
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.capacity = 1024;
+    config.load_fac_max = 100;
+    config.mode = HTUI32_MODE_CHAINING;
+    config.allocator = &allocator;
+    htui32_init_ex(&ht, &config);
+
+    // About a third of 1000 keys in 1024 buckets are collision chain items
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        htui32_put(&ht, i * 4096, i);
+    }
+    assert(ht.capacity == 1024);
+    size_t chain_items_count = 0;
+    for (size_t i = 0; i < ht.capacity; ++i) {
+        for (hash_table_uint32_item_t* current_item = ht.memory_ptr[i].next; current_item != NULL; current_item = current_item->next) {
+            chain_items_count++;
+        }
+    }
+    assert(chain_items_count > 100);
+    // One allocation for the buckets and a few for the pool blocks
+    size_t alloc_count = counters.alloc_count;
+    assert(alloc_count < 10);
+
+    // Released items are reused
+    for (uint32_t round = 0; round < 10; ++round) {
+        for (uint32_t i = 1; i <= 1000; ++i) {
+            htui32_delete(&ht, i * 4096 + round);
+        }
+        for (uint32_t i = 1; i <= 1000; ++i) {
+            htui32_put(&ht, i * 4096 + round + 1, i);
+        }
+    }
+    assert(ht.size == 1000);
+    assert(counters.alloc_count == alloc_count);
+    uint32_t value = 0;
+    for (uint32_t i = 1; i <= 1000; ++i) {
+        bool has_found = htui32_get(&ht, i * 4096 + 10, &value);
+        assert(has_found == true);
+        assert(value == i);
+    }
+
+    // Blocks are freed at once
+    htui32_destroy(&ht);
+    assert(counters.free_count == counters.alloc_count);
+    assert(counters.allocated_bytes == 0);
+}
+
+void test_batch()
+{
+    htui32_mode_t modes[] = { HTUI32_MODE_CHAINING, HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_ROBIN_HOOD, HTUI32_MODE_SWISS };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        hash_table_uint32_t ht;
+        memset(&ht, 0, sizeof(ht));
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.mode = modes[m];
+        htui32_init_ex(&ht, &config);
+
+        // Keys 0..999 by 4096, the last key repeats the first one with another value
+        uint32_t keys[1001];
+        uint32_t values[1001];
+        bool found[1001];
+        for (uint32_t i = 0; i < 1000; ++i) {
+            keys[i] = i * 4096;
+            values[i] = i;
+        }
+        keys[1000] = 0;
+        values[1000] = 1000;
+
+        // Empty table
+        memset(found, true, sizeof(found));
+        htui32_get_batch(&ht, keys, NULL, found, 1001);
+        for (uint32_t i = 0; i < 1001; ++i) {
+            assert(found[i] == false);
+        }
+
+        htui32_put_batch(&ht, keys, values, 1001);
+        assert(ht.size == 1000);
+
+        // Hits and misses
+        for (uint32_t i = 0; i < 1000; ++i) {
+            keys[i] = (i % 2 == 0) ? i * 4096 : i * 4096 + 1;
+        }
+        memset(values, 0xFF, sizeof(values));
+        htui32_get_batch(&ht, keys, values, found, 1000);
+        for (uint32_t i = 0; i < 1000; ++i) {
+            assert(found[i] == (i % 2 == 0));
+            if (i == 0) {
+                assert(values[i] == 1000);
+            }
+            else if (i % 2 == 0) {
+                assert(values[i] == i);
+            }
+            else {
+                // Value of a missing key is not written
+                assert(values[i] == 0xFFFFFFFF);
+            }
+        }
+
+        // Delete the found keys, misses are ignored
+        htui32_delete_batch(&ht, keys, 1000);
+        assert(ht.size == 500);
+        for (uint32_t i = 0; i < 1000; ++i) {
+            bool has_found = htui32_get(&ht, i * 4096, NULL);
+            assert(has_found == (i % 2 == 1));
+        }
+
+        htui32_destroy(&ht);
+    }
+}
+
+void test_reduction()
+{
+    htui32_mode_t modes[] = { HTUI32_MODE_CHAINING, HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_ROBIN_HOOD };
+    htui32_reduction_t reductions[] = { HTUI32_REDUCTION_MASK, HTUI32_REDUCTION_FASTRANGE };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        for (size_t r = 0; r < sizeof(reductions) / sizeof(reductions[0]); ++r) {
+            hash_table_uint32_t ht;
+            memset(&ht, 0, sizeof(ht));
+            htui32_config_t config;
+            memset(&config, 0, sizeof(config));
+            config.capacity = 100;
+            config.mode = modes[m];
+            config.reduction = reductions[r];
+            config.incremental_rehash = (r == 1);
+            htui32_init_ex(&ht, &config);
+            assert(ht.reduction == reductions[r]);
+            // Only the mask needs a power of two capacity
+            assert(ht.capacity == (reductions[r] == HTUI32_REDUCTION_MASK ? 128 : 100));
+            size_t initial_capacity = ht.capacity;
+
+            // Page aligned keys, the low bits of the keys are all zero
+            uint32_t value = 0;
+            bool has_found = false;
+            for (uint32_t i = 1; i <= 5000; ++i) {
+                htui32_put(&ht, i * 4096, i);
+            }
+            assert(ht.size == 5000);
+            for (uint32_t i = 1; i <= 5000; ++i) {
+                has_found = htui32_get(&ht, i * 4096, &value);
+                assert(has_found == true);
+                assert(value == i);
+            }
+            has_found = htui32_get(&ht, 5001 * 4096, NULL);
+            assert(has_found == false);
+
+            for (uint32_t i = 1; i <= 5000; i += 2) {
+                htui32_delete(&ht, i * 4096);
+            }
+            assert(ht.size == 2500);
+            for (uint32_t i = 1; i <= 5000; ++i) {
+                has_found = htui32_get(&ht, i * 4096, NULL);
+                assert(has_found == (i % 2 == 0));
+            }
+
+            for (uint32_t i = 2; i <= 5000; i += 2) {
+                htui32_delete(&ht, i * 4096);
+            }
+            assert(ht.size == 0);
+            assert(ht.capacity == initial_capacity);
+
+            htui32_destroy(&ht);
+        }
+    }
+}
+
+void test_stats()
+{
+    htui32_mode_t modes[] = { HTUI32_MODE_CHAINING, HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_ROBIN_HOOD, HTUI32_MODE_SWISS };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        hash_table_uint32_t ht;
+        memset(&ht, 0, sizeof(ht));
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.mode = modes[m];
+        htui32_init_ex(&ht, &config);
+
+        htui32_stats_t stats;
+        htui32_stats(&ht, &stats);
+        assert(stats.size == 0);
+        assert(stats.capacity == ht.capacity);
+        assert(stats.used_buckets == 0);
+        assert(stats.max_chain_length == 0);
+        assert(stats.chain_length_histogram[0] == ht.capacity);
+        assert(stats.memory_bytes == ht.memory_size);
+
+        // The key 0 is not in the chains
+        for (uint32_t i = 0; i < 1000; ++i) {
+            htui32_put(&ht, i * 4096, i);
+        }
+        for (uint32_t i = 0; i < 1000; ++i) {
+            htui32_get(&ht, i * 4096 + 1, NULL);
+        }
+        htui32_stats(&ht, &stats);
+        assert(stats.size == 1000);
+        assert(stats.capacity == ht.capacity);
+        assert(stats.used_buckets > 0 && stats.used_buckets <= 999);
+        assert(stats.max_chain_length >= 1);
+        assert(stats.mean_chain_length_x100 >= 100);
+        assert(stats.mean_chain_length_x100 <= stats.max_chain_length * 100);
+        size_t buckets_count = 0;
+        size_t chains_length = 0;
+        for (size_t i = 0; i < HTUI32_STATS_HISTOGRAM_SIZE; ++i) {
+            buckets_count += stats.chain_length_histogram[i];
+            chains_length += i * stats.chain_length_histogram[i];
+        }
+        assert(buckets_count == ht.capacity);
+        if (modes[m] == HTUI32_MODE_CHAINING) {
+            // Every key is in exactly one chain
+            assert(chains_length == 999 || stats.max_chain_length >= HTUI32_STATS_HISTOGRAM_SIZE);
+            assert(stats.overflow_items == 999 - stats.used_buckets);
+            assert(stats.memory_bytes > ht.memory_size);
+        }
+        else {
+            assert(stats.used_buckets == 999);
+            assert(stats.overflow_items == 0);
+            assert(stats.memory_bytes == ht.memory_size);
+        }
+
+        assert(stats.counters_enabled == (HTUI32_STATS != 0));
+        if (stats.counters_enabled) {
+            assert(stats.counters.grow_count > 0);
+            assert(stats.counters.shrink_count == 0);
+            // Every put of a new key and every get looks up the key
+            assert(stats.counters.lookups_count >= 1999);
+            assert(stats.counters.probe_steps_count >= stats.counters.lookups_count);
+            for (uint32_t i = 0; i < 1000; ++i) {
+                htui32_delete(&ht, i * 4096);
+            }
+            htui32_stats(&ht, &stats);
+            assert(stats.counters.shrink_count > 0);
+        }
+        else {
+            assert(stats.counters.grow_count == 0);
+            assert(stats.counters.lookups_count == 0);
+        }
+
+        htui32_destroy(&ht);
+    }
+}
+
+void test_reserve_and_build()
+{
+    htui32_mode_t modes[] = { HTUI32_MODE_CHAINING, HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_ROBIN_HOOD, HTUI32_MODE_SWISS, HTUI32_MODE_CHAINING };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        hash_table_uint32_t ht;
+        memset(&ht, 0, sizeof(ht));
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.mode = modes[m];
+        // The last chaining pass uses the mask reduction and incremental rehashing
+        if (m == sizeof(modes) / sizeof(modes[0]) - 1) {
+            config.reduction = HTUI32_REDUCTION_MASK;
+            config.incremental_rehash = true;
+        }
+        htui32_init_ex(&ht, &config);
+
+        // Reserved keys are put without growing
+        bool is_reserved = htui32_reserve(&ht, 1000);
+        assert(is_reserved == true);
+        size_t capacity = ht.capacity;
+        assert(capacity >= 1000 * 100 / ht.load_fac_max);
+        for (uint32_t i = 0; i < 1000; ++i) {
+            htui32_put(&ht, i * 4096, i);
+        }
+        assert(ht.size == 1000);
+        assert(ht.capacity == capacity);
+        // Reserve never shrinks
+        is_reserved = htui32_reserve(&ht, 10);
+        assert(is_reserved == true);
+        assert(ht.capacity == capacity);
+
+        // Build on top of the existing keys, the key 0 is already there
+        uint32_t keys[3000];
+        uint32_t values[3000];
+        for (uint32_t i = 0; i < 3000; ++i) {
+            keys[i] = (1000 + i) * 4096;
+            values[i] = 1000 + i;
+        }
+        bool is_built = htui32_build(&ht, keys, values, 3000);
+        assert(is_built == true);
+        assert(ht.size == 4000);
+        capacity = ht.capacity;
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < 4000; ++i) {
+            bool has_found = htui32_get(&ht, i * 4096, &value);
+            assert(has_found == true);
+            assert(value == i);
+        }
+        assert(htui32_get(&ht, 4000 * 4096, NULL) == false);
+
+        // The built table is an ordinary table
+        for (uint32_t i = 0; i < 4000; i += 2) {
+            htui32_delete(&ht, i * 4096);
+        }
+        assert(ht.size == 2000);
+        for (uint32_t i = 0; i < 4000; ++i) {
+            bool has_found = htui32_get(&ht, i * 4096, NULL);
+            assert(has_found == (i % 2 == 1));
+        }
+        htui32_destroy(&ht);
+
+        // Build of an empty table with the key 0
+        memset(&ht, 0, sizeof(ht));
+        htui32_init_ex(&ht, &config);
+        keys[0] = 0;
+        is_built = htui32_build(&ht, keys, values, 3000);
+        assert(is_built == true);
+        assert(ht.size == 3000);
+        assert(htui32_get(&ht, 0, &value) == true);
+        assert(value == 1000);
+        assert(htui32_get(&ht, 1001 * 4096, &value) == true);
+        assert(value == 1001);
+        htui32_destroy(&ht);
+    }
+}
+
+void test_growth_policy()
+{
+    htui32_mode_t modes[] = { HTUI32_MODE_CHAINING, HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_SWISS };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        hash_table_uint32_t ht;
+        memset(&ht, 0, sizeof(ht));
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.mode = modes[m];
+        // Right after growing the load is 37%, below load_fac_min
+        config.load_fac_min = 40;
+        config.load_fac_max = 75;
+        htui32_init_ex(&ht, &config);
+        assert(ht.load_fac_hysteresis == 10);
+        assert(ht.growth_fac == 200);
+        assert(ht.auto_shrink == true);
+
+        // Put keys until a put grows the table
+        uint32_t key = 0;
+        size_t capacity = ht.capacity;
+        do {
+            ++key;
+            capacity = ht.capacity;
+            htui32_put(&ht, key * 4096, key);
+        } while (ht.capacity == capacity || ht.size < 100);
+        capacity = ht.capacity;
+        // The delete does not shrink the table back, so the put does not grow it again
+        for (uint32_t round = 0; round < 10; ++round) {
+            htui32_delete(&ht, key * 4096);
+            assert(ht.capacity == capacity);
+            htui32_put(&ht, key * 4096, key);
+            assert(ht.capacity == capacity);
+        }
+        // Still shrinks when enough keys are deleted
+        while (ht.capacity == capacity) {
+            htui32_delete(&ht, key * 4096);
+            --key;
+        }
+        assert(ht.capacity < capacity);
+        // And the load after shrinking is below the hysteresis band
+        assert(ht.size * 100 <= ht.capacity * (75 - 10));
+        for (uint32_t i = 1; i <= key; ++i) {
+            assert(htui32_get(&ht, i * 4096, NULL) == true);
+        }
+        htui32_destroy(&ht);
+    }
+
+    // Growth factor
+    hash_table_uint32_t ht;
+    memset(&ht, 0, sizeof(ht));
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.capacity = 100;
+    config.growth_fac = 150;
+    htui32_init_ex(&ht, &config);
+    for (uint32_t i = 1; i <= 75; ++i) {
+        htui32_put(&ht, i, i);
+    }
+    assert(ht.capacity == 150);
+    for (uint32_t i = 1; i <= 75; ++i) {
+        htui32_delete(&ht, i);
+    }
+    assert(ht.capacity == 100);
+    htui32_destroy(&ht);
+
+    // Power of two capacities double whatever the growth factor is
+    memset(&ht, 0, sizeof(ht));
+    config.reduction = HTUI32_REDUCTION_MASK;
+    htui32_init_ex(&ht, &config);
+    assert(ht.capacity == 128);
+    for (uint32_t i = 1; i <= 96; ++i) {
+        htui32_put(&ht, i, i);
+    }
+    assert(ht.capacity == 256);
+    htui32_destroy(&ht);
+
+    // Growth factor must be over 100%
+    memset(&ht, 0, sizeof(ht));
+    config.growth_fac = 100;
+    htui32_init_ex(&ht, &config);
+    assert(ht.capacity == 0);
+
+    // Without automatic shrinking only htui32_compact reduces the capacity
+    htui32_mode_t compact_modes[] = { HTUI32_MODE_CHAINING, HTUI32_MODE_ROBIN_HOOD, HTUI32_MODE_SWISS, HTUI32_MODE_CHAINING };
+    for (size_t m = 0; m < sizeof(compact_modes) / sizeof(compact_modes[0]); ++m) {
+        memset(&ht, 0, sizeof(ht));
+        memset(&config, 0, sizeof(config));
+        config.mode = compact_modes[m];
+        config.disable_auto_shrink = true;
+        // The last chaining pass uses incremental rehashing
+        config.incremental_rehash = (m == sizeof(compact_modes) / sizeof(compact_modes[0]) - 1);
+        htui32_init_ex(&ht, &config);
+        for (uint32_t i = 0; i < 10000; ++i) {
+            htui32_put(&ht, i * 4096, i);
+        }
+        size_t capacity = ht.capacity;
+        for (uint32_t i = 0; i < 10000; ++i) {
+            if (i % 100 != 0) {
+                htui32_delete(&ht, i * 4096);
+            }
+        }
+        assert(ht.size == 100);
+        assert(ht.capacity == capacity);
+
+        bool is_compacted = htui32_compact(&ht);
+        assert(is_compacted == true);
+        assert(ht.capacity < capacity);
+        assert(ht.size * 100 <= ht.capacity * (ht.load_fac_max - ht.load_fac_hysteresis));
+        assert(ht.old_memory_ptr == NULL);
+        assert(ht.deleted_count == 0);
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < 10000; i += 100) {
+            bool has_found = htui32_get(&ht, i * 4096, &value);
+            assert(has_found == true);
+            assert(value == i);
+        }
+        // Compact of the empty table goes back to the initial capacity
+        for (uint32_t i = 0; i < 10000; i += 100) {
+            htui32_delete(&ht, i * 4096);
+        }
+        htui32_compact(&ht);
+        assert(ht.size == 0);
+        assert(ht.capacity == ht.initial_capacity);
+        htui32_destroy(&ht);
+    }
+}
+
+void test_snapshot()
+{
+    const char* path = "test_snapshot.bin";
+    htui32_mode_t modes[] = { HTUI32_MODE_CHAINING, HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_ROBIN_HOOD, HTUI32_MODE_SWISS };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        hash_table_uint32_t ht;
+        memset(&ht, 0, sizeof(ht));
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.mode = modes[m];
+        htui32_init_ex(&ht, &config);
+        htui32_put(&ht, 0, 777);
+        // Page aligned keys collide in the chains of the snapshot
+        for (uint32_t i = 1; i <= 5000; ++i) {
+            htui32_put(&ht, i * 4096, i);
+        }
+        bool is_saved = htui32_save(&ht, path);
+        assert(is_saved == true);
+        htui32_destroy(&ht);
+
+        hash_table_uint32_t snapshot;
+        bool is_opened = htui32_open_mmap(&snapshot, path);
+        assert(is_opened == true);
+        assert(snapshot.mode == HTUI32_MODE_SNAPSHOT);
+        assert(snapshot.size == 5001);
+        uint32_t value = 0;
+        bool has_found = htui32_get(&snapshot, 0, &value);
+        assert(has_found == true);
+        assert(value == 777);
+        for (uint32_t i = 1; i <= 5000; ++i) {
+            has_found = htui32_get(&snapshot, i * 4096, &value);
+            assert(has_found == true);
+            assert(value == i);
+        }
+        for (uint32_t i = 5001; i <= 6000; ++i) {
+            assert(htui32_get(&snapshot, i * 4096, NULL) == false);
+        }
+        assert(htui32_get(&snapshot, 1, NULL) == false);
+
+        uint32_t keys[] = { 4096, 1, 0, 5000 * 4096 };
+        uint32_t values[4];
+        bool found[4];
+        htui32_get_batch(&snapshot, keys, values, found, 4);
+        assert(found[0] == true && values[0] == 1);
+        assert(found[1] == false);
+        assert(found[2] == true && values[2] == 777);
+        assert(found[3] == true && values[3] == 5000);
+
+        // The snapshot is read-only
+        htui32_put(&snapshot, 1, 1);
+        htui32_delete(&snapshot, 4096);
+        bool is_reserved = htui32_reserve(&snapshot, 100000);
+        assert(is_reserved == false);
+        assert(snapshot.size == 5001);
+        assert(htui32_get(&snapshot, 1, NULL) == false);
+        assert(htui32_get(&snapshot, 4096, NULL) == true);
+
+        htui32_stats_t stats;
+        htui32_stats(&snapshot, &stats);
+        assert(stats.size == 5001);
+        assert(stats.memory_bytes == snapshot.snapshot_size);
+        assert(stats.used_buckets + stats.overflow_items == 5000);
+
+        // A mapped snapshot can be saved again
+        is_saved = htui32_save(&snapshot, path);
+        htui32_destroy(&snapshot);
+        assert(snapshot.snapshot_ptr == NULL);
+        assert(is_saved == true);
+        is_opened = htui32_open_mmap(&snapshot, path);
+        assert(is_opened == true);
+        has_found = htui32_get(&snapshot, 2500 * 4096, &value);
+        assert(has_found == true);
+        assert(value == 2500);
+        htui32_destroy(&snapshot);
+    }
+
+    // Neither a missing file nor a file of another format is opened
+    hash_table_uint32_t ht;
+    remove(path);
+    bool is_opened = htui32_open_mmap(&ht, path);
+    assert(is_opened == false);
+    FILE* file = fopen(path, "wb");
+    assert(file != NULL);
+    char garbage[256];
+    memset(garbage, 0x5a, sizeof(garbage));
+    fwrite(garbage, 1, sizeof(garbage), file);
+    fclose(file);
+    is_opened = htui32_open_mmap(&ht, path);
+    assert(is_opened == false);
+    remove(path);
+
+    // The snapshot mode can not be requested
+    memset(&ht, 0, sizeof(ht));
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.mode = HTUI32_MODE_SNAPSHOT;
+    htui32_init_ex(&ht, &config);
+    assert(ht.capacity == 0);
+}
+
+void test_frozen()
+{
+    htui32_mode_t modes[] = { HTUI32_MODE_CHAINING, HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_SWISS };
+    uint32_t counts[] = { 0, 1, 7, 1000, 100000 };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); ++c) {
+            hash_table_uint32_t ht;
+            memset(&ht, 0, sizeof(ht));
+            htui32_config_t config;
+            memset(&config, 0, sizeof(config));
+            config.mode = modes[m];
+            htui32_init_ex(&ht, &config);
+            htui32_put(&ht, 0, 777);
+            for (uint32_t i = 1; i <= counts[c]; ++i) {
+                htui32_put(&ht, i * 4096, i);
+            }
+            bool is_frozen = htui32_freeze(&ht);
+            assert(is_frozen == true);
+            assert(ht.mode == HTUI32_MODE_FROZEN);
+            assert(ht.size == counts[c] + 1);
+            // The slots are at most 8% more than the keys
+            assert(ht.capacity <= counts[c] + counts[c] * 8 / 100 + 1);
+
+            uint32_t value = 0;
+            bool has_found = htui32_frozen_get(&ht, 0, &value);
+            assert(has_found == true);
+            assert(value == 777);
+            for (uint32_t i = 1; i <= counts[c]; ++i) {
+                has_found = htui32_frozen_get(&ht, i * 4096, &value);
+                assert(has_found == true);
+                assert(value == i);
+                has_found = htui32_get(&ht, i * 4096, &value);
+                assert(has_found == true);
+                assert(value == i);
+            }
+            for (uint32_t i = counts[c] + 1; i <= counts[c] + 1000; ++i) {
+                assert(htui32_frozen_get(&ht, i * 4096, NULL) == false);
+                assert(htui32_get(&ht, i * 4096, NULL) == false);
+            }
+
+            // The frozen table is read-only
+            htui32_put(&ht, 1, 1);
+            htui32_delete(&ht, 0);
+            assert(htui32_get(&ht, 1, NULL) == false);
+            assert(htui32_get(&ht, 0, NULL) == true);
+            assert(ht.size == counts[c] + 1);
+            is_frozen = htui32_freeze(&ht);
+            assert(is_frozen == true);
+
+            htui32_stats_t stats;
+            htui32_stats(&ht, &stats);
+            assert(stats.used_buckets == counts[c]);
+            assert(stats.max_chain_length == (counts[c] != 0 ? 1 : 0));
+            htui32_destroy(&ht);
+        }
+    }
+
+    // Only a frozen table is read by htui32_frozen_get
+    hash_table_uint32_t ht;
+    memset(&ht, 0, sizeof(ht));
+    htui32_init(&ht, 16, 0, 0);
+    htui32_put(&ht, 1, 1);
+    assert(htui32_frozen_get(&ht, 1, NULL) == false);
+    htui32_destroy(&ht);
+}
+
+void test_compact_chaining()
+{
+    hash_table_uint32_t ht;
+    memset(&ht, 0, sizeof(ht));
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.mode = HTUI32_MODE_COMPACT_CHAINING;
+    config.capacity = 8;
+    config.reduction = HTUI32_REDUCTION_MODULO;
+    // This test without rehash
+    config.load_fac_max = 100;
+    config.load_fac_min = 1;
+    htui32_init_ex(&ht, &config);
+    assert(ht.capacity == 8);
+    assert(ht.memory_size == 8 * sizeof(hash_table_uint32_slot_t));
+    assert(ht.overflow_ptr == NULL);
+
+    // Keys of the same bucket, the second one moves both keys to a chain
+    uint32_t bucket_keys[4];
+    size_t bucket_keys_count = 0;
+    size_t bucket = htui32_hash(1) % 8;
+    for (uint32_t key = 1; bucket_keys_count < 4; ++key) {
+        if (htui32_hash(key) % 8 == bucket) {
+            bucket_keys[bucket_keys_count++] = key;
+        }
+    }
+    htui32_put(&ht, bucket_keys[0], 100);
+    assert(ht.slots_ptr[bucket].key == bucket_keys[0]);
+    assert(ht.overflow_used == 0);
+    htui32_put(&ht, bucket_keys[1], 101);
+    htui32_put(&ht, bucket_keys[2], 102);
+    assert(ht.slots_ptr[bucket].key == 0);
+    assert(ht.slots_ptr[bucket].value != 0);
+    assert(ht.overflow_used == 3);
+    assert(ht.size == 3);
+    uint32_t value = 0;
+    for (size_t i = 0; i < 3; ++i) {
+        bool has_found = htui32_get(&ht, bucket_keys[i], &value);
+        assert(has_found == true);
+        assert(value == 100 + i);
+    }
+    assert(htui32_get(&ht, bucket_keys[3], NULL) == false);
+    htui32_put(&ht, bucket_keys[1], 201);
+    assert(htui32_get(&ht, bucket_keys[1], &value) == true);
+    assert(value == 201);
+
+    // Deleting leaves the last key of the chain in the bucket, its chain items are reused
+    htui32_delete(&ht, bucket_keys[0]);
+    assert(ht.slots_ptr[bucket].key == 0);
+    htui32_delete(&ht, bucket_keys[2]);
+    assert(ht.slots_ptr[bucket].key == bucket_keys[1]);
+    assert(ht.slots_ptr[bucket].value == 201);
+    assert(ht.overflow_free != 0);
+    htui32_put(&ht, bucket_keys[3], 103);
+    htui32_put(&ht, bucket_keys[0], 100);
+    assert(ht.overflow_used == 3);
+    assert(ht.size == 3);
+    htui32_delete(&ht, bucket_keys[1]);
+    htui32_delete(&ht, bucket_keys[3]);
+    htui32_delete(&ht, bucket_keys[0]);
+    assert(ht.size == 0);
+    assert(ht.slots_ptr[bucket].key == 0);
+    assert(ht.slots_ptr[bucket].value == 0);
+    htui32_destroy(&ht);
+
+    // Less than two thirds of the memory of the chaining mode
+    hash_table_uint32_t chaining_ht;
+    memset(&chaining_ht, 0, sizeof(chaining_ht));
+    memset(&ht, 0, sizeof(ht));
+    memset(&config, 0, sizeof(config));
+    config.mode = HTUI32_MODE_COMPACT_CHAINING;
+    htui32_init_ex(&ht, &config);
+    config.mode = HTUI32_MODE_CHAINING;
+    htui32_init_ex(&chaining_ht, &config);
+    htui32_put(&ht, 0, 777);
+    for (uint32_t i = 1; i <= 100000; ++i) {
+        htui32_put(&ht, i * 4096, i);
+        htui32_put(&chaining_ht, i * 4096, i);
+    }
+    assert(ht.capacity == chaining_ht.capacity);
+    htui32_stats_t stats;
+    htui32_stats_t chaining_stats;
+    htui32_stats(&ht, &stats);
+    htui32_stats(&chaining_ht, &chaining_stats);
+    assert(stats.size == 100001);
+    assert(stats.memory_bytes * 3 < chaining_stats.memory_bytes * 2);
+    assert(stats.used_buckets == chaining_stats.used_buckets);
+    assert(stats.max_chain_length == chaining_stats.max_chain_length);
+    assert(htui32_get(&ht, 0, &value) == true);
+    assert(value == 777);
+    // Shrinking rehashes the chains too
+    for (uint32_t i = 1; i <= 100000; ++i) {
+        if (i % 10 != 0) {
+            htui32_delete(&ht, i * 4096);
+        }
+    }
+    assert(ht.capacity < chaining_ht.capacity);
+    for (uint32_t i = 1; i <= 100000; ++i) {
+        assert(htui32_get(&ht, i * 4096, &value) == (i % 10 == 0));
+        assert(i % 10 != 0 || value == i);
+    }
+    // The rehashed chains leave room for the next collisions
+    assert(ht.overflow_used != 0);
+    assert(ht.overflow_capacity >= ht.overflow_used + ht.overflow_used / 2);
+    htui32_destroy(&ht);
+    htui32_destroy(&chaining_ht);
+}
+
+// Allocator of the tables that must never allocate
+static void* failing_alloc(void* context, size_t size)
+{
+    (void)size;
+    ((counting_allocator_context_t*)context)->alloc_count++;
+    return NULL;
+}
+
+// Static storage for the fixed-capacity tables
+static uint64_t fixed_buffer[4096];
+
+void test_fixed()
+{
+    counting_allocator_context_t counters;
+    memset(&counters, 0, sizeof(counters));
+    htui32_allocator_t allocator;
+    allocator.alloc = failing_alloc;
+    allocator.free = counting_free;
+    allocator.context = &counters;
+
+    htui32_mode_t modes[] = { HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_ROBIN_HOOD, HTUI32_MODE_SWISS };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        hash_table_uint32_t ht;
+        memset(&ht, 0, sizeof(ht));
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.capacity = 1000;
+        config.mode = modes[m];
+        config.allocator = &allocator;
+        size_t buffer_size = htui32_fixed_buffer_size(&config);
+        assert(buffer_size >= 1000 * sizeof(hash_table_uint32_slot_t));
+        assert(buffer_size <= sizeof(fixed_buffer));
+
+        // Too small or misaligned buffers are refused
+        bool is_initialized = htui32_init_fixed(&ht, &config, fixed_buffer, buffer_size - 1);
+        assert(is_initialized == false);
+        assert(ht.capacity == 0);
+        bool is_put = htui32_put(&ht, 4096, 1);
+        assert(is_put == false);
+        is_initialized = htui32_init_fixed(&ht, &config, (char*)fixed_buffer + 1, buffer_size);
+        assert(is_initialized == false);
+        is_initialized = htui32_init_fixed(&ht, &config, fixed_buffer, buffer_size);
+        assert(is_initialized == true);
+        assert(ht.memory_size == buffer_size);
+        assert((void*)ht.slots_ptr == (void*)fixed_buffer);
+
+        // The key 0 counts in the hard capacity too
+        is_put = htui32_put(&ht, 0, 999);
+        assert(is_put == true);
+        for (uint32_t i = 1; i < 1000; ++i) {
+            is_put = htui32_put(&ht, i * 4096, i);
+            assert(is_put == true);
+        }
+        assert(ht.size == 1000);
+        size_t capacity = ht.capacity;
+        is_put = htui32_put(&ht, 1000 * 4096, 1000);
+        assert(is_put == false);
+        assert(htui32_get(&ht, 1000 * 4096, NULL) == false);
+        // Existing keys still get their values
+        is_put = htui32_put(&ht, 4096, 111);
+        assert(is_put == true);
+        uint32_t value = 0;
+        assert(htui32_get(&ht, 4096, &value) == true);
+        assert(value == 111);
+        bool is_reserved = htui32_reserve(&ht, 1000);
+        assert(is_reserved == true);
+        is_reserved = htui32_reserve(&ht, 1001);
+        assert(is_reserved == false);
+
+        // Delete and put churn neither shrinks nor grows the table, DELETED slots of the Swiss table mode are dropped in place
+        for (uint32_t round = 0; round < 20; ++round) {
+            for (uint32_t i = 1; i < 1000; i += 2) {
+                htui32_delete(&ht, i * 4096 + round);
+            }
+            is_put = htui32_put(&ht, 0, 999);
+            assert(is_put == true);
+            for (uint32_t i = 1; i < 1000; i += 2) {
+                is_put = htui32_put(&ht, i * 4096 + round + 1, i);
+                assert(is_put == true);
+            }
+            assert(ht.size == 1000);
+            assert(ht.capacity == capacity);
+        }
+        for (uint32_t i = 2; i < 1000; i += 2) {
+            assert(htui32_get(&ht, i * 4096, &value) == true);
+            assert(value == i);
+        }
+        for (uint32_t i = 1; i < 1000; i += 2) {
+            assert(htui32_get(&ht, i * 4096 + 20, &value) == true);
+            assert(value == i);
+        }
+        bool is_compacted = htui32_compact(&ht);
+        assert(is_compacted == true);
+        assert(ht.capacity == capacity);
+        assert(ht.deleted_count == 0);
+        for (uint32_t i = 1; i < 1000; i += 2) {
+            assert(htui32_get(&ht, i * 4096 + 20, NULL) == true);
+        }
+        bool is_frozen = htui32_freeze(&ht);
+        assert(is_frozen == false);
+
+        for (uint32_t i = 1; i < 1000; ++i) {
+            htui32_delete(&ht, i * 4096 + ((i % 2 == 1) ? 20 : 0));
+        }
+        assert(ht.size == 1);
+        assert(ht.capacity == capacity);
+        htui32_destroy(&ht);
+        assert(counters.alloc_count == 0);
+        assert(counters.free_count == 0);
+    }
+
+    // The chaining modes allocate their chain items, so they cannot use a buffer
+    hash_table_uint32_t ht;
+    memset(&ht, 0, sizeof(ht));
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.capacity = 1000;
+    config.mode = HTUI32_MODE_CHAINING;
+    assert(htui32_fixed_buffer_size(&config) == 0);
+    bool is_initialized = htui32_init_fixed(&ht, &config, fixed_buffer, sizeof(fixed_buffer));
+    assert(is_initialized == false);
+    config.mode = HTUI32_MODE_LINEAR_PROBING;
+    config.capacity = 0;
+    assert(htui32_fixed_buffer_size(&config) == 0);
+}
+
+void test_upsert()
+{
+    htui32_mode_t modes[] = { HTUI32_MODE_CHAINING, HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_ROBIN_HOOD, HTUI32_MODE_SWISS, HTUI32_MODE_COMPACT_CHAINING };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        hash_table_uint32_t ht;
+        memset(&ht, 0, sizeof(ht));
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.capacity = 4;
+        config.mode = modes[m];
+        htui32_init_ex(&ht, &config);
+
+        // Get or insert puts the default value once and returns the same value afterwards
+        for (uint32_t i = 0; i < 1000; ++i) {
+            uint32_t* value_ptr = htui32_get_or_insert(&ht, i * 4096, i);
+            assert(value_ptr != NULL);
+            assert(*value_ptr == i);
+            *value_ptr += 1;
+        }
+        assert(ht.size == 1000);
+        for (uint32_t i = 0; i < 1000; ++i) {
+            uint32_t* value_ptr = htui32_get_or_insert(&ht, i * 4096, 0);
+            assert(value_ptr != NULL);
+            assert(*value_ptr == i + 1);
+        }
+        assert(ht.size == 1000);
+
+        // Insert if absent does not change existing keys
+        bool is_inserted = htui32_insert_if_absent(&ht, 4096, 777);
+        assert(is_inserted == false);
+        is_inserted = htui32_insert_if_absent(&ht, 0, 777);
+        assert(is_inserted == false);
+        is_inserted = htui32_insert_if_absent(&ht, 1000 * 4096, 777);
+        assert(is_inserted == true);
+        uint32_t value = 0;
+        assert(htui32_get(&ht, 4096, &value) == true);
+        assert(value == 2);
+        assert(htui32_get(&ht, 1000 * 4096, &value) == true);
+        assert(value == 777);
+        assert(ht.size == 1001);
+
+        // Reference counts: new keys start from 0, the values wrap around
+        uint32_t old_value = 1;
+        bool is_added = false;
+        for (uint32_t i = 0; i < 3; ++i) {
+            is_added = htui32_fetch_add(&ht, 2000 * 4096, 1, &old_value);
+            assert(is_added == true);
+            assert(old_value == i);
+        }
+        is_added = htui32_fetch_add(&ht, 2000 * 4096, (uint32_t)-1, &old_value);
+        assert(is_added == true);
+        assert(old_value == 3);
+        is_added = htui32_fetch_add(&ht, 0, 10, NULL);
+        assert(is_added == true);
+        assert(htui32_get(&ht, 0, &value) == true);
+        assert(value == 11);
+        assert(htui32_get(&ht, 2000 * 4096, &value) == true);
+        assert(value == 2);
+        is_added = htui32_fetch_add(&ht, 2001 * 4096, (uint32_t)-1, &old_value);
+        assert(is_added == true);
+        assert(old_value == 0);
+        assert(htui32_get(&ht, 2001 * 4096, &value) == true);
+        assert(value == UINT32_MAX);
+
+        // Compare and set never puts a key
+        bool is_set = htui32_compare_and_set(&ht, 2000 * 4096, 1, 5);
+        assert(is_set == false);
+        is_set = htui32_compare_and_set(&ht, 2000 * 4096, 2, 5);
+        assert(is_set == true);
+        assert(htui32_get(&ht, 2000 * 4096, &value) == true);
+        assert(value == 5);
+        is_set = htui32_compare_and_set(&ht, 0, 11, 12);
+        assert(is_set == true);
+        is_set = htui32_compare_and_set(&ht, 3000 * 4096, 0, 1);
+        assert(is_set == false);
+        assert(htui32_get(&ht, 3000 * 4096, NULL) == false);
+        size_t size = ht.size;
+        assert(size == 1003);
+
+        // An update of an existing key is one lookup, a new key is one lookup unless it grows the table
+        htui32_stats_t stats;
+        htui32_stats(&ht, &stats);
+        uint64_t lookups_count = stats.counters.lookups_count;
+        for (uint32_t i = 1; i < 1000; ++i) {
+            htui32_fetch_add(&ht, i * 4096, 1, NULL);
+        }
+        htui32_stats(&ht, &stats);
+        assert(!stats.counters_enabled || stats.counters.lookups_count == lookups_count + 999);
+        assert(ht.size == size);
+        for (uint32_t i = 1; i < 1000; ++i) {
+            assert(htui32_get(&ht, i * 4096, &value) == true);
+            assert(value == i + 2);
+        }
+
+        // Deleting keys and putting them back keeps the tables consistent
+        for (uint32_t i = 1; i < 1000; i += 2) {
+            htui32_delete(&ht, i * 4096);
+        }
+        for (uint32_t i = 1; i < 1000; ++i) {
+            is_inserted = htui32_insert_if_absent(&ht, i * 4096, i);
+            assert(is_inserted == (i % 2 == 1));
+            assert(htui32_get(&ht, i * 4096, &value) == true);
+            assert(value == ((i % 2 == 1) ? i : i + 2));
+        }
+        htui32_destroy(&ht);
+    }
+
+    // A full fixed-capacity table still updates its keys
+    static uint64_t buffer[64];
+    hash_table_uint32_t ht;
+    memset(&ht, 0, sizeof(ht));
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.capacity = 8;
+    config.mode = HTUI32_MODE_LINEAR_PROBING;
+    bool is_initialized = htui32_init_fixed(&ht, &config, buffer, sizeof(buffer));
+    assert(is_initialized == true);
+    bool is_added = false;
+    for (uint32_t i = 1; i <= 8; ++i) {
+        is_added = htui32_fetch_add(&ht, i, 1, NULL);
+        assert(is_added == true);
+    }
+    is_added = htui32_fetch_add(&ht, 9, 1, NULL);
+    assert(is_added == false);
+    uint32_t* value_ptr = htui32_get_or_insert(&ht, 9, 1);
+    assert(value_ptr == NULL);
+    bool is_inserted = htui32_insert_if_absent(&ht, 9, 1);
+    assert(is_inserted == false);
+    is_added = htui32_fetch_add(&ht, 8, 1, NULL);
+    assert(is_added == true);
+    value_ptr = htui32_get_or_insert(&ht, 8, 0);
+    assert(value_ptr != NULL && *value_ptr == 2);
+    htui32_destroy(&ht);
+
+    // Frozen tables are not changed, neither is a missing table
+    memset(&ht, 0, sizeof(ht));
+    htui32_init(&ht, 16, 0, 0);
+    htui32_put(&ht, 1, 1);
+    bool is_frozen = htui32_freeze(&ht);
+    assert(is_frozen == true);
+    hash_table_uint32_t* tables[] = { &ht, NULL };
+    for (size_t t = 0; t < sizeof(tables) / sizeof(tables[0]); ++t) {
+        value_ptr = htui32_get_or_insert(tables[t], 2, 1);
+        assert(value_ptr == NULL);
+        is_inserted = htui32_insert_if_absent(tables[t], 2, 1);
+        assert(is_inserted == false);
+        is_added = htui32_fetch_add(tables[t], 1, 1, NULL);
+        assert(is_added == false);
+        bool is_set = htui32_compare_and_set(tables[t], 1, 1, 5);
+        assert(is_set == false);
+    }
+    uint32_t value = 0;
+    bool has_found = htui32_get(&ht, 1, &value);
+    assert(has_found == true);
+    assert(value == 1);
+    has_found = htui32_get(&ht, 2, NULL);
+    assert(has_found == false);
+    assert(ht.size == 1);
+    htui32_destroy(&ht);
+}
+
+void test_cuckoo()
+{
+    hash_table_uint32_t ht;
+    memset(&ht, 0, sizeof(ht));
+    htui32_config_t config;
+    memset(&config, 0, sizeof(config));
+    config.mode = HTUI32_MODE_CUCKOO;
+    config.capacity = 1000;
+    htui32_init_ex(&ht, &config);
+    // The capacity is a power of two, the buckets are aligned to their size
+    assert(ht.capacity == 1024);
+    assert(ht.load_fac_max == 90);
+    assert(((uintptr_t)ht.slots_ptr % (HTUI32_CUCKOO_BUCKET_SLOTS * sizeof(hash_table_uint32_slot_t))) == 0);
+    htui32_destroy(&ht);
+
+    // 95% of the slots are used without growing, every key is in one of its two buckets
+    memset(&ht, 0, sizeof(ht));
+    config.capacity = 1 << 16;
+    config.load_fac_max = 96;
+    config.load_fac_min = 1;
+    htui32_init_ex(&ht, &config);
+    uint32_t count = (1 << 16) * 95 / 100;
+    htui32_put(&ht, 0, 777);
+    for (uint32_t i = 1; i <= count; ++i) {
+        bool is_put = htui32_put(&ht, i * 7919, i);
+        assert(is_put == true);
+    }
+    assert(ht.capacity == 1 << 16);
+    htui32_stats_t stats;
+    htui32_stats(&ht, &stats);
+    assert(stats.size == count + 1);
+    assert(stats.max_chain_length <= 2);
+    uint32_t value = 0;
+    for (uint32_t i = 1; i <= count; ++i) {
+        assert(htui32_get(&ht, i * 7919, &value) == true);
+        assert(value == i);
+    }
+    assert(htui32_get(&ht, 7919 * (count + 1), NULL) == false);
+    assert(htui32_get(&ht, 0, &value) == true);
+    assert(value == 777);
+
+    // Updates and deletes do not move the other keys
+    htui32_put(&ht, 7919, 1000);
+    assert(htui32_get(&ht, 7919, &value) == true);
+    assert(value == 1000);
+    for (uint32_t i = 1; i <= count; i += 2) {
+        htui32_delete(&ht, i * 7919);
+    }
+    for (uint32_t i = 1; i <= count; ++i) {
+        assert(htui32_get(&ht, i * 7919, NULL) == (i % 2 == 0));
+    }
+    htui32_destroy(&ht);
+
+    // A full table grows even below load_fac_max when a key does not fit into its buckets, then shrinks back on deletes
+    memset(&ht, 0, sizeof(ht));
+    memset(&config, 0, sizeof(config));
+    config.mode = HTUI32_MODE_CUCKOO;
+    config.capacity = 16;
+    config.load_fac_max = 100;
+    htui32_init_ex(&ht, &config);
+    for (uint32_t i = 1; i <= 100000; ++i) {
+        bool is_put = htui32_put(&ht, i, i + 1);
+        assert(is_put == true);
+    }
+    assert(ht.size == 100000);
+    for (uint32_t i = 1; i <= 100000; ++i) {
+        assert(htui32_get(&ht, i, &value) == true);
+        assert(value == i + 1);
+    }
+    size_t grown_capacity = ht.capacity;
+    for (uint32_t i = 1; i <= 100000; ++i) {
+        if (i % 100 != 0) {
+            htui32_delete(&ht, i);
+        }
+    }
+    assert(ht.capacity < grown_capacity);
+    for (uint32_t i = 1; i <= 100000; ++i) {
+        assert(htui32_get(&ht, i, NULL) == (i % 100 == 0));
+    }
+    htui32_destroy(&ht);
+}
+
+// Counts the keys of test_iterator, the keys are i * 7 for i in [1, ITERATOR_KEYS] and the key 0
+#define ITERATOR_KEYS 6500
+
+static void count_seen_key(void* context, uint32_t key, uint32_t value)
+{
+    uint8_t* seen = context;
+    assert(key % 7 == 0);
+    assert(value == key + 1);
+    seen[key / 7]++;
+}
+
+void test_iterator()
+{
+    static uint8_t seen[ITERATOR_KEYS + 1];
+    static uint32_t keys[ITERATOR_KEYS + 1];
+    static uint32_t values[ITERATOR_KEYS + 1];
+    htui32_mode_t modes[] = { HTUI32_MODE_CHAINING, HTUI32_MODE_LINEAR_PROBING, HTUI32_MODE_ROBIN_HOOD, HTUI32_MODE_SWISS,
+        HTUI32_MODE_COMPACT_CHAINING, HTUI32_MODE_CUCKOO, HTUI32_MODE_FROZEN };
+    for (size_t m = 0; m < sizeof(modes) / sizeof(modes[0]); ++m) {
+        hash_table_uint32_t ht;
+        memset(&ht, 0, sizeof(ht));
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.mode = (modes[m] == HTUI32_MODE_FROZEN) ? HTUI32_MODE_CHAINING : modes[m];
+        // Incremental rehashing is left in progress, the iterator walks the old buckets too
+        config.incremental_rehash = true;
+        htui32_init_ex(&ht, &config);
+        for (uint32_t i = 0; i <= ITERATOR_KEYS; ++i) {
+            htui32_put(&ht, i * 7, i * 7 + 1);
+        }
+        if (modes[m] == HTUI32_MODE_FROZEN) {
+            bool is_frozen = htui32_freeze(&ht);
+            assert(is_frozen == true);
+        }
+        assert(modes[m] != HTUI32_MODE_CHAINING || ht.old_memory_ptr != NULL);
+
+        // Every key once, the key 0 first
+        htui32_iter_t iter;
+        htui32_iter_init(&iter, &ht);
+        memset(seen, 0, sizeof(seen));
+        uint32_t key = 0;
+        uint32_t value = 0;
+        size_t count = 0;
+        while (htui32_iter_next(&iter, &key, &value)) {
+            assert(count != 0 || key == 0);
+            count_seen_key(seen, key, value);
+            count++;
+        }
+        assert(count == ITERATOR_KEYS + 1);
+        bool has_next = htui32_iter_next(&iter, &key, &value);
+        assert(has_next == false);
+        for (uint32_t i = 0; i <= ITERATOR_KEYS; ++i) {
+            assert(seen[i] == 1);
+        }
+
+        memset(seen, 0, sizeof(seen));
+        htui32_foreach(&ht, count_seen_key, seen);
+        for (uint32_t i = 0; i <= ITERATOR_KEYS; ++i) {
+            assert(seen[i] == 1);
+        }
+
+        // Export stops at the end of the arrays
+        size_t exported_count = htui32_export(&ht, keys, values, 100);
+        assert(exported_count == 100);
+        exported_count = htui32_export(&ht, keys, NULL, ITERATOR_KEYS + 1);
+        assert(exported_count == ITERATOR_KEYS + 1);
+        memset(seen, 0, sizeof(seen));
+        exported_count = htui32_export(&ht, keys, values, ITERATOR_KEYS + 1);
+        assert(exported_count == ITERATOR_KEYS + 1);
+        for (uint32_t i = 0; i <= ITERATOR_KEYS; ++i) {
+            count_seen_key(seen, keys[i], values[i]);
+        }
+        for (uint32_t i = 0; i <= ITERATOR_KEYS; ++i) {
+            assert(seen[i] == 1);
+        }
+
+        if (modes[m] == HTUI32_MODE_FROZEN) {
+            htui32_iter_init(&iter, &ht);
+            has_next = htui32_iter_next(&iter, &key, &value);
+            assert(has_next == true);
+            bool is_deleted = htui32_iter_delete(&iter);
+            assert(is_deleted == false);
+            htui32_destroy(&ht);
+            continue;
+        }
+
+        // Deleting the current key, every other key is still returned once, then deleting all keys
+        for (size_t pass = 0; pass < 2; ++pass) {
+            htui32_iter_init(&iter, &ht);
+            bool is_deleted = htui32_iter_delete(&iter);
+            assert(is_deleted == false);
+            memset(seen, 0, sizeof(seen));
+            size_t size = ht.size;
+            while (htui32_iter_next(&iter, &key, &value)) {
+                count_seen_key(seen, key, value);
+                if (pass == 1 || (key / 7) % 3 != 0) {
+                    is_deleted = htui32_iter_delete(&iter);
+                    assert(is_deleted == true);
+                    is_deleted = htui32_iter_delete(&iter);
+                    assert(is_deleted == false);
+                    size--;
+                    assert(ht.size == size);
+                }
+            }
+            for (uint32_t i = 0; i <= ITERATOR_KEYS; ++i) {
+                assert(seen[i] == ((pass == 0 || i % 3 == 0) ? 1 : 0));
+                assert(htui32_get(&ht, i * 7, NULL) == (pass == 0 && i % 3 == 0));
+            }
+        }
+        assert(ht.size == 0);
+        htui32_iter_init(&iter, &ht);
+        has_next = htui32_iter_next(&iter, &key, &value);
+        assert(has_next == false);
+        htui32_destroy(&ht);
+    }
+
+    // A table that is not initialized has no keys
+    htui32_iter_t iter;
+    htui32_iter_init(&iter, NULL);
+    uint32_t key = 0;
+    bool has_next = htui32_iter_next(&iter, &key, NULL);
+    assert(has_next == false);
+    size_t exported_count = htui32_export(NULL, &key, NULL, 1);
+    assert(exported_count == 0);
+}
+
+// Allocator that fails the small allocations (collision chain item pool blocks) while fail_small is set, bucket arrays still get memory
+typedef struct {
+    bool fail_small;
+} small_failing_allocator_context_t;
+
+static void* small_failing_alloc(void* context, size_t size)
+{
+    small_failing_allocator_context_t* allocator_context = context;
+    if (allocator_context->fail_small && size < 1024) {
+        return NULL;
+    }
+    return malloc(size);
+}
+
+static void small_failing_free(void* context, void* ptr, size_t size)
+{
+    (void)context;
+    (void)size;
+    free(ptr);
+}
+
+void test_rehash_alloc_failure()
+{
+    for (size_t pass = 0; pass < 2; ++pass) {
+        small_failing_allocator_context_t allocator_context;
+        allocator_context.fail_small = false;
+        htui32_allocator_t allocator;
+        allocator.alloc = small_failing_alloc;
+        allocator.free = small_failing_free;
+        allocator.context = &allocator_context;
+
+        hash_table_uint32_t ht;
+        memset(&ht, 0, sizeof(ht));
+        htui32_config_t config;
+        memset(&config, 0, sizeof(config));
+        config.mode = HTUI32_MODE_CHAINING;
+        config.capacity = 16;
+        config.incremental_rehash = (pass == 0);
+        config.allocator = &allocator;
+        htui32_init_ex(&ht, &config);
+        bool is_reserved = htui32_reserve(&ht, 700);
+        assert(is_reserved == true);
+        // Deletes of missing keys move the buckets, but they do nothing in an empty table
+        uint32_t keys[100];
+        keys[0] = 1;
+        size_t keys_count = 1;
+        htui32_put(&ht, keys[0], keys[0] + 1);
+        while (ht.old_memory_ptr != NULL) {
+            htui32_delete(&ht, 0xFFFFFFFF);
+        }
+        size_t capacity = ht.capacity;
+
+        // Every key is alone in its bucket, so the item pool has no memory,
+        // but the buckets b and b + capacity / 2 merge when the table shrinks
+        for (uint32_t key = 2; keys_count < 100; ++key) {
+            bool is_free = true;
+            for (size_t i = 0; i < keys_count; ++i) {
+                is_free = is_free && htui32_hash(keys[i]) % capacity != htui32_hash(key) % capacity;
+            }
+            if (is_free) {
+                keys[keys_count++] = key;
+                htui32_put(&ht, key, key + 1);
+            }
+        }
+        assert(ht.item_pool.item_blocks_ptr == NULL);
+
+        // The table shrinks, but no bucket that holds a key can be moved
+        allocator_context.fail_small = true;
+        htui32_delete(&ht, keys[0]);
+        assert(ht.capacity < capacity);
+        assert(ht.old_memory_ptr != NULL);
+        for (uint32_t i = 0; i < 1000; ++i) {
+            htui32_delete(&ht, 0xFFFFFFFF - i);
+        }
+        assert(ht.old_memory_ptr != NULL);
+        assert(ht.size == 99);
+        uint32_t value = 0;
+        for (size_t i = 1; i < keys_count; ++i) {
+            assert(htui32_get(&ht, keys[i], &value) == true);
+            assert(value == keys[i] + 1);
+        }
+
+        // The moving goes on once the memory can be allocated
+        allocator_context.fail_small = false;
+        while (ht.old_memory_ptr != NULL) {
+            htui32_delete(&ht, 0xFFFFFFFF);
+        }
+        assert(ht.size == 99);
+        htui32_stats_t stats;
+        htui32_stats(&ht, &stats);
+        assert(stats.size == 99);
+        for (size_t i = 1; i < keys_count; ++i) {
+            assert(htui32_get(&ht, keys[i], &value) == true);
+            assert(value == keys[i] + 1);
+        }
+        htui32_destroy(&ht);
+    }
+}
@@ -7,4 +7,44 @@ extern void test_put_and_get_rehash();
 
 extern void test_delete();
 
+extern void test_open_addressing();
+
+extern void test_swiss();
+
+extern void test_incremental_rehash();
+
+extern void test_rehash_step_size();
+
+extern void test_rehash_relink();
+
+extern void test_allocator();
+
+extern void test_item_pool();
+
+extern void test_batch();
+
+extern void test_reduction();
+
+extern void test_stats();
+
+extern void test_reserve_and_build();
+
+extern void test_growth_policy();
+
+extern void test_snapshot();
+
+extern void test_frozen();
+
+extern void test_compact_chaining();
+
+extern void test_fixed();
+
+extern void test_upsert();
+
+extern void test_cuckoo();
+
+extern void test_iterator();
+
+extern void test_rehash_alloc_failure();
+
 #endif